@@ -0,0 +1,9 @@
+// all benchmarks
+// build with -DCMAKE_BUILD_TYPE=Release, numbers from an unoptimized build mean nothing
+
+#include <benchmark/benchmark.h>
+
+#include "benchmarks/all_benchmarks.h"
+
+
+BENCHMARK_MAIN();
@@ -0,0 +1,8 @@
+// all benchmarks
+
+#pragma once
+
+#include "priority_queue_bench.h"
+#include "charconv_bench.h"
+#include "multi_matcher_bench.h"
+#include "sort_bench.h"
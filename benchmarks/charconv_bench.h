@@ -0,0 +1,254 @@
+// charconv benchmark
+
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+#include "../lib/String.h"
+
+
+// values spread over many magnitudes
+inline Vector<long long> BenchInts(const size_t& n) {
+    std::mt19937_64 gen(42);
+    Vector<long long> ret;
+    ret.reserve(n);
+    for(size_t i = 0; i < n; ++i) ret.push_back((long long)gen() >> (gen() % 64));
+    return ret;
+}
+inline Vector<double> BenchDoubles(const size_t& n) {
+    std::mt19937_64 gen(42);
+    std::uniform_real_distribution<double> mantissa(1.0, 10.0);
+    Vector<double> ret;
+    ret.reserve(n);
+    for(size_t i = 0; i < n; ++i) ret.push_back(mantissa(gen) * std::pow(10.0, (int)(gen() % 40) - 20));
+    return ret;
+}
+
+static const size_t BENCH_CONVERSIONS = 1 << 16;
+
+
+// formatting: every variant writes the values one after another into a single buffer
+
+void BM_AppendInt(benchmark::State& state) {
+    Vector<long long> v = BenchInts(BENCH_CONVERSIONS);
+    String s;
+    for(auto _ : state) {
+        s = String();
+        s.reserve(BENCH_CONVERSIONS * INT_CHARS_MAX);
+        for(size_t i = 0; i < v.size(); ++i) s.append_int(v.at_unchecked(i));
+        benchmark::DoNotOptimize(s.c_str());
+    }
+    state.SetItemsProcessed(state.iterations() * v.size());
+}
+BENCHMARK(BM_AppendInt);
+
+void BM_SnprintfInt(benchmark::State& state) {
+    Vector<long long> v = BenchInts(BENCH_CONVERSIONS);
+    Vector<char> buf(BENCH_CONVERSIONS * (INT_CHARS_MAX + 1), 0);
+    for(auto _ : state) {
+        char *p = buf.data();
+        for(size_t i = 0; i < v.size(); ++i) p += snprintf(p, INT_CHARS_MAX + 1, "%lld", v.at_unchecked(i));
+        benchmark::DoNotOptimize(p);
+    }
+    state.SetItemsProcessed(state.iterations() * v.size());
+}
+BENCHMARK(BM_SnprintfInt);
+
+void BM_StdToCharsInt(benchmark::State& state) {
+    Vector<long long> v = BenchInts(BENCH_CONVERSIONS);
+    Vector<char> buf(BENCH_CONVERSIONS * INT_CHARS_MAX, 0);
+    for(auto _ : state) {
+        char *p = buf.data();
+        for(size_t i = 0; i < v.size(); ++i) p = std::to_chars(p, p + INT_CHARS_MAX, v.at_unchecked(i)).ptr;
+        benchmark::DoNotOptimize(p);
+    }
+    state.SetItemsProcessed(state.iterations() * v.size());
+}
+BENCHMARK(BM_StdToCharsInt);
+
+void BM_AppendDouble(benchmark::State& state) {
+    Vector<double> v = BenchDoubles(BENCH_CONVERSIONS);
+    String s;
+    for(auto _ : state) {
+        s = String();
+        s.reserve(BENCH_CONVERSIONS * DOUBLE_CHARS_MAX);
+        for(size_t i = 0; i < v.size(); ++i) s.append_double(v.at_unchecked(i));
+        benchmark::DoNotOptimize(s.c_str());
+    }
+    state.SetItemsProcessed(state.iterations() * v.size());
+}
+BENCHMARK(BM_AppendDouble);
+
+// %.17g round trips too, but is not the shortest text
+void BM_SnprintfDouble(benchmark::State& state) {
+    Vector<double> v = BenchDoubles(BENCH_CONVERSIONS);
+    Vector<char> buf(BENCH_CONVERSIONS * DOUBLE_CHARS_MAX, 0);
+    for(auto _ : state) {
+        char *p = buf.data();
+        for(size_t i = 0; i < v.size(); ++i) p += snprintf(p, DOUBLE_CHARS_MAX, "%.17g", v.at_unchecked(i));
+        benchmark::DoNotOptimize(p);
+    }
+    state.SetItemsProcessed(state.iterations() * v.size());
+}
+BENCHMARK(BM_SnprintfDouble);
+
+void BM_StdToCharsDouble(benchmark::State& state) {
+    Vector<double> v = BenchDoubles(BENCH_CONVERSIONS);
+    Vector<char> buf(BENCH_CONVERSIONS * DOUBLE_CHARS_MAX, 0);
+    for(auto _ : state) {
+        char *p = buf.data();
+        for(size_t i = 0; i < v.size(); ++i) p = std::to_chars(p, p + DOUBLE_CHARS_MAX, v.at_unchecked(i)).ptr;
+        benchmark::DoNotOptimize(p);
+    }
+    state.SetItemsProcessed(state.iterations() * v.size());
+}
+BENCHMARK(BM_StdToCharsDouble);
+
+
+// parsing: a comma separated list built once
+
+template <class T>
+String BenchCsv(const Vector<T>& v) {
+    String s;
+    for(size_t i = 0; i < v.size(); ++i) {
+        if constexpr (std::is_integral<T>::value) s.append_int(v.at_unchecked(i));
+        else s.append_double(v.at_unchecked(i));
+        s += ',';
+    }
+    return s;
+}
+
+void BM_ParseInt(benchmark::State& state) {
+    String s = BenchCsv(BenchInts(BENCH_CONVERSIONS));
+    for(auto _ : state) {
+        long long sum = 0;
+        for(size_t pos = 0; pos < s.length(); ++pos) sum += s.parse_int(&pos);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * BENCH_CONVERSIONS);
+}
+BENCHMARK(BM_ParseInt);
+
+void BM_StrtollInt(benchmark::State& state) {
+    String s = BenchCsv(BenchInts(BENCH_CONVERSIONS));
+    for(auto _ : state) {
+        long long sum = 0;
+        char *end;
+        for(const char *p = s.c_str(); *p != '\0'; p = end + 1) sum += strtoll(p, &end, 10);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * BENCH_CONVERSIONS);
+}
+BENCHMARK(BM_StrtollInt);
+
+void BM_StdFromCharsInt(benchmark::State& state) {
+    String s = BenchCsv(BenchInts(BENCH_CONVERSIONS));
+    for(auto _ : state) {
+        long long sum = 0, x;
+        const char *last = s.c_str() + s.length();
+        for(const char *p = s.c_str(); p < last; ++p) {
+            std::from_chars_result r = std::from_chars(p, last, x);
+            p = r.ptr;
+            // x is left unset on failure
+            if(r.ec == std::errc()) sum += x;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * BENCH_CONVERSIONS);
+}
+BENCHMARK(BM_StdFromCharsInt);
+
+void BM_ParseDouble(benchmark::State& state) {
+    String s = BenchCsv(BenchDoubles(BENCH_CONVERSIONS));
+    for(auto _ : state) {
+        double sum = 0;
+        for(size_t pos = 0; pos < s.length(); ++pos) sum += s.parse_double(&pos);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * BENCH_CONVERSIONS);
+}
+BENCHMARK(BM_ParseDouble);
+
+void BM_StrtodDouble(benchmark::State& state) {
+    String s = BenchCsv(BenchDoubles(BENCH_CONVERSIONS));
+    for(auto _ : state) {
+        double sum = 0;
+        char *end;
+        for(const char *p = s.c_str(); *p != '\0'; p = end + 1) sum += strtod(p, &end);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * BENCH_CONVERSIONS);
+}
+BENCHMARK(BM_StrtodDouble);
+
+void BM_StdFromCharsDouble(benchmark::State& state) {
+    String s = BenchCsv(BenchDoubles(BENCH_CONVERSIONS));
+    for(auto _ : state) {
+        double sum = 0, x;
+        const char *last = s.c_str() + s.length();
+        for(const char *p = s.c_str(); p < last; ++p) {
+            std::from_chars_result r = std::from_chars(p, last, x);
+            p = r.ptr;
+            // x is left unset on failure
+            if(r.ec == std::errc()) sum += x;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * BENCH_CONVERSIONS);
+}
+BENCHMARK(BM_StdFromCharsDouble);
+
+// prices with two decimals, the common case the exact fast path covers
+inline Vector<double> BenchPrices(const size_t& n) {
+    std::mt19937_64 gen(42);
+    Vector<double> ret;
+    ret.reserve(n);
+    for(size_t i = 0; i < n; ++i) ret.push_back((double)(gen() % 10000000) / 100);
+    return ret;
+}
+
+void BM_ParseDoubleShort(benchmark::State& state) {
+    String s = BenchCsv(BenchPrices(BENCH_CONVERSIONS));
+    for(auto _ : state) {
+        double sum = 0;
+        for(size_t pos = 0; pos < s.length(); ++pos) sum += s.parse_double(&pos);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * BENCH_CONVERSIONS);
+}
+BENCHMARK(BM_ParseDoubleShort);
+
+void BM_StrtodDoubleShort(benchmark::State& state) {
+    String s = BenchCsv(BenchPrices(BENCH_CONVERSIONS));
+    for(auto _ : state) {
+        double sum = 0;
+        char *end;
+        for(const char *p = s.c_str(); *p != '\0'; p = end + 1) sum += strtod(p, &end);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * BENCH_CONVERSIONS);
+}
+BENCHMARK(BM_StrtodDoubleShort);
+
+void BM_StdFromCharsDoubleShort(benchmark::State& state) {
+    String s = BenchCsv(BenchPrices(BENCH_CONVERSIONS));
+    for(auto _ : state) {
+        double sum = 0, x;
+        const char *last = s.c_str() + s.length();
+        for(const char *p = s.c_str(); p < last; ++p) {
+            std::from_chars_result r = std::from_chars(p, last, x);
+            p = r.ptr;
+            // x is left unset on failure
+            if(r.ec == std::errc()) sum += x;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * BENCH_CONVERSIONS);
+}
+BENCHMARK(BM_StdFromCharsDoubleShort);
@@ -0,0 +1,116 @@
+// multi matcher benchmark
+
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include <random>
+
+#include "../lib/MultiMatcher.h"
+#include "../lib/String.h"
+#include "../lib/Vector.h"
+
+
+// n random lowercase keywords of 6 to 12 letters, each prefixed with prefix
+inline Vector<String> BenchKeywords(const size_t& n, const char* prefix = "") {
+    std::mt19937 gen(1);
+    Vector<String> ret;
+    ret.reserve(n);
+    for(size_t i = 0; i < n; ++i) {
+        String w(prefix);
+        size_t len = 6 + gen() % 7;
+        for(size_t j = 0; j < len; ++j) w += (char)('a' + gen() % 26);
+        ret.push_back(w);
+    }
+    return ret;
+}
+
+// about 1 MiB of 80 column lines of random words, one word in 64 is a keyword
+inline Vector<String> BenchLines(const Vector<String>& keywords) {
+    std::mt19937 gen(2);
+    Vector<String> ret;
+    for(size_t total = 0; total < (1 << 20); ) {
+        String line;
+        while(line.length() < 80) {
+            if(gen() % 64 == 0) line += keywords.at_unchecked(gen() % keywords.size());
+            else for(size_t j = 3 + gen() % 6; j > 0; --j) line += (char)('a' + gen() % 26);
+            line += ' ';
+        }
+        total += line.length() + 1;
+        ret.push_back(line);
+    }
+    return ret;
+}
+
+inline String BenchText(const Vector<String>& lines) {
+    String ret;
+    for(size_t i = 0; i < lines.size(); ++i) {
+        ret += lines.at_unchecked(i);
+        ret += '\n';
+    }
+    return ret;
+}
+
+// every hit in one pass over the whole text
+void BM_MultiMatcher_Scan(benchmark::State& state) {
+    Vector<String> keywords = BenchKeywords(state.range(0));
+    String text = BenchText(BenchLines(keywords));
+    MultiMatcher m(keywords);
+    for(auto _ : state) {
+        size_t hits = 0;
+        m.scan(text, [&hits](const size_t&, const size_t&) { ++hits; });
+        benchmark::DoNotOptimize(hits);
+    }
+    state.SetBytesProcessed(state.iterations() * text.length());
+    state.counters["table_kb"] = m.table_size() * sizeof(uint32_t) / 1024.0;
+}
+BENCHMARK(BM_MultiMatcher_Scan)->RangeMultiplier(10)->Range(1, 1000);
+
+// every keyword starts with '[', which is rare in the text: memchr skips between candidates
+void BM_MultiMatcher_ScanPrefiltered(benchmark::State& state) {
+    Vector<String> keywords = BenchKeywords(state.range(0), "[");
+    String text = BenchText(BenchLines(keywords));
+    MultiMatcher m(keywords);
+    for(auto _ : state) {
+        size_t hits = 0;
+        m.scan(text, [&hits](const size_t&, const size_t&) { ++hits; });
+        benchmark::DoNotOptimize(hits);
+    }
+    state.SetBytesProcessed(state.iterations() * text.length());
+}
+BENCHMARK(BM_MultiMatcher_ScanPrefiltered)->RangeMultiplier(10)->Range(1, 1000);
+
+// does the line hold any keyword
+void BM_MultiMatcher_ContainsLine(benchmark::State& state) {
+    Vector<String> keywords = BenchKeywords(state.range(0));
+    Vector<String> lines = BenchLines(keywords);
+    MultiMatcher m(keywords);
+    size_t bytes = BenchText(lines).length();
+    for(auto _ : state) {
+        size_t kept = 0;
+        for(size_t i = 0; i < lines.size(); ++i) kept += m.contains(lines.at_unchecked(i));
+        benchmark::DoNotOptimize(kept);
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK(BM_MultiMatcher_ContainsLine)->RangeMultiplier(10)->Range(1, 1000);
+
+// the same with one String::match per keyword, cost grows with the number of keywords
+void BM_StringMatch_ContainsLine(benchmark::State& state) {
+    Vector<String> keywords = BenchKeywords(state.range(0));
+    Vector<String> lines = BenchLines(keywords);
+    size_t bytes = BenchText(lines).length();
+    for(auto _ : state) {
+        size_t kept = 0;
+        for(size_t i = 0; i < lines.size(); ++i) {
+            for(size_t k = 0; k < keywords.size(); ++k) {
+                if(lines.at_unchecked(i).match(keywords.at_unchecked(k).c_str())) {
+                    ++kept;
+                    break;
+                }
+            }
+        }
+        benchmark::DoNotOptimize(kept);
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK(BM_StringMatch_ContainsLine)->RangeMultiplier(10)->Range(1, 100);
@@ -0,0 +1,85 @@
+// priority queue benchmark
+
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include <functional>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include "../lib/PriorityQueue.h"
+
+
+// the same pseudo random keys for every queue
+inline Vector<int> BenchKeys(const size_t& n) {
+    std::mt19937 gen(42);
+    Vector<int> ret;
+    ret.reserve(n);
+    for(size_t i = 0; i < n; ++i) ret.push_back((int)gen());
+    return ret;
+}
+
+// push n keys, then pop them all
+template <size_t Arity>
+void BM_PriorityQueue_PushPop(benchmark::State& state) {
+    Vector<int> keys = BenchKeys(state.range(0));
+    for(auto _ : state) {
+        PriorityQueue<int, Less, Arity> q;
+        q.reserve(keys.size());
+        for(size_t i = 0; i < keys.size(); ++i) q.push(keys.at_unchecked(i));
+        while(!q.empty()) {
+            benchmark::DoNotOptimize(q.top());
+            q.pop();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_PriorityQueue_PushPop, 2)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+BENCHMARK_TEMPLATE(BM_PriorityQueue_PushPop, 4)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+BENCHMARK_TEMPLATE(BM_PriorityQueue_PushPop, 8)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+
+void BM_StdPriorityQueue_PushPop(benchmark::State& state) {
+    Vector<int> keys = BenchKeys(state.range(0));
+    for(auto _ : state) {
+        std::vector<int> storage;
+        storage.reserve(keys.size());
+        std::priority_queue<int, std::vector<int>, std::greater<int>> q(std::greater<int>(), std::move(storage));
+        for(size_t i = 0; i < keys.size(); ++i) q.push(keys.at_unchecked(i));
+        while(!q.empty()) {
+            benchmark::DoNotOptimize(q.top());
+            q.pop();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StdPriorityQueue_PushPop)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+
+// bulk build, the copy of the keys is excluded
+template <size_t Arity>
+void BM_PriorityQueue_Heapify(benchmark::State& state) {
+    Vector<int> keys = BenchKeys(state.range(0));
+    for(auto _ : state) {
+        state.PauseTiming();
+        Vector<int> v(keys);
+        state.ResumeTiming();
+        PriorityQueue<int, Less, Arity> q(std::move(v));
+        benchmark::DoNotOptimize(q.top());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_PriorityQueue_Heapify, 2)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+BENCHMARK_TEMPLATE(BM_PriorityQueue_Heapify, 4)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+
+void BM_StdPriorityQueue_Heapify(benchmark::State& state) {
+    Vector<int> keys = BenchKeys(state.range(0));
+    for(auto _ : state) {
+        state.PauseTiming();
+        std::vector<int> v(keys.begin(), keys.end());
+        state.ResumeTiming();
+        std::priority_queue<int, std::vector<int>, std::greater<int>> q(std::greater<int>(), std::move(v));
+        benchmark::DoNotOptimize(q.top());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StdPriorityQueue_Heapify)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
@@ -0,0 +1,106 @@
+// sort benchmark, 1M to 100M keys (the copy of the input before every sort is not timed)
+
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <random>
+
+#include "../lib/Sort.h"
+#include "../lib/String.h"
+#include "../lib/Vector.h"
+
+
+inline Vector<uint64_t> BenchSortKeys(const size_t& n) {
+    std::mt19937_64 gen(11);
+    Vector<uint64_t> ret;
+    ret.reserve(n);
+    for(size_t i = 0; i < n; ++i) ret.push_back(gen());
+    return ret;
+}
+
+// identifiers with a shared prefix, as in sorted log or table keys ("user:" then 4 to 12 letters)
+inline Vector<String> BenchSortStrings(const size_t& n) {
+    std::mt19937 gen(12);
+    Vector<String> ret;
+    ret.reserve(n);
+    for(size_t i = 0; i < n; ++i) {
+        String s("user:");
+        s.reserve(5 + 12);
+        for(size_t j = 4 + gen() % 9; j > 0; --j) s += (char)('a' + gen() % 26);
+        ret.push_back(std::move(s));
+    }
+    return ret;
+}
+
+// radix sort, the scratch is kept between iterations
+void BM_SortVector_U64(benchmark::State& state) {
+    Vector<uint64_t> keys = BenchSortKeys(state.range(0)), v, scratch;
+    for(auto _ : state) {
+        state.PauseTiming();
+        v = keys;
+        state.ResumeTiming();
+        SortVector(v, scratch);
+        benchmark::DoNotOptimize(v.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SortVector_U64)->Arg(1000000)->Arg(10000000)->Arg(100000000)->Unit(benchmark::kMillisecond);
+
+// pattern defeating quicksort
+void BM_Sort_U64(benchmark::State& state) {
+    Vector<uint64_t> keys = BenchSortKeys(state.range(0)), v;
+    for(auto _ : state) {
+        state.PauseTiming();
+        v = keys;
+        state.ResumeTiming();
+        Sort(v.data(), v.data() + v.size());
+        benchmark::DoNotOptimize(v.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Sort_U64)->Arg(1000000)->Arg(10000000)->Arg(100000000)->Unit(benchmark::kMillisecond);
+
+void BM_StdSort_U64(benchmark::State& state) {
+    Vector<uint64_t> keys = BenchSortKeys(state.range(0)), v;
+    for(auto _ : state) {
+        state.PauseTiming();
+        v = keys;
+        state.ResumeTiming();
+        std::sort(v.data(), v.data() + v.size());
+        benchmark::DoNotOptimize(v.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StdSort_U64)->Arg(1000000)->Arg(10000000)->Arg(100000000)->Unit(benchmark::kMillisecond);
+
+// multikey quicksort
+void BM_SortVector_String(benchmark::State& state) {
+    Vector<String> strings = BenchSortStrings(state.range(0)), v;
+    for(auto _ : state) {
+        state.PauseTiming();
+        v = strings;
+        state.ResumeTiming();
+        SortVector(v);
+        benchmark::DoNotOptimize(v.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SortVector_String)->Arg(1000000)->Arg(10000000)->Unit(benchmark::kMillisecond);
+
+void BM_StdSort_String(benchmark::State& state) {
+    Vector<String> strings = BenchSortStrings(state.range(0)), v;
+    for(auto _ : state) {
+        state.PauseTiming();
+        v = strings;
+        state.ResumeTiming();
+        std::sort(v.data(), v.data() + v.size(), [](const String& a, const String& b) {
+            return strcmp(a.c_str(), b.c_str()) < 0;
+        });
+        benchmark::DoNotOptimize(v.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StdSort_String)->Arg(1000000)->Arg(10000000)->Unit(benchmark::kMillisecond);
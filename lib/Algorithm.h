@@ -2,22 +2,282 @@
 
 #pragma once
 
+#include <cstddef>
+#include <utility>
 
-// requires copy assignment
+
+// all algorithms here are constexpr, so compile-time tables can be built with them
+
+// requires move assignment
 template <class T>
-inline void Swap(T& a, T& b) {
-    T tmp = a;
-    a = b;
-    b = tmp;
+constexpr void Swap(T& a, T& b) {
+    T tmp = std::move(a);
+    a = std::move(b);
+    b = std::move(tmp);
 }
 
 // requires operator< overloaded
 template <class T>
-inline const T& Min(const T& a, const T& b) { return a <= b ? a : b; }
+constexpr const T& Min(const T& a, const T& b) { return a <= b ? a : b; }
 
 // requires iterator
 template<class Iter>
-void Reverse(const Iter& first, const Iter& last) {
+constexpr void Reverse(const Iter& first, const Iter& last) {
     Iter left = first, right = last;
     while(left < right) Swap(*(left++), *(--right));
 }
+
+
+// default comparison (operator<), works for any pair of types
+struct Less {
+    template <class T, class U>
+    constexpr bool operator()(const T& a, const U& b) const { return a < b; }
+};
+
+// reversed order (b < a), e.g. a max-first PriorityQueue
+struct Greater {
+    template <class T, class U>
+    constexpr bool operator()(const T& a, const U& b) const { return b < a; }
+};
+
+// requires random access iterator (or pointer)
+template <class Iter, class Compare>
+constexpr void InsertionSort(Iter first, Iter last, Compare comp) {
+    if(first == last) return;
+    for(Iter i = first + 1; i != last; ++i) {
+        auto tmp = std::move(*i);
+        Iter j = i;
+        for(Iter k = j - 1; comp(tmp, *k); --k) {
+            *j = std::move(*k);
+            --j;
+            if(k == first) break;
+        }
+        *j = std::move(tmp);
+    }
+}
+
+// insertion sort for a range that has an element no greater than *first just before it, so the scan needs no bound
+template <class Iter, class Compare>
+constexpr void _UnguardedInsertionSort(Iter first, Iter last, Compare& comp) {
+    if(first == last) return;
+    for(Iter i = first + 1; i != last; ++i) {
+        if(!comp(*i, *(i - 1))) continue;
+        auto tmp = std::move(*i);
+        Iter j = i;
+        do {
+            *j = std::move(*(j - 1));
+            --j;
+        } while(comp(tmp, *(j - 1)));
+        *j = std::move(tmp);
+    }
+}
+
+// insertion sort that gives up after a few moves, true if the range ended up sorted
+template <class Iter, class Compare>
+constexpr bool _PartialInsertionSort(Iter first, Iter last, Compare& comp) {
+    if(first == last) return true;
+    size_t moves = 0;
+    for(Iter i = first + 1; i != last; ++i) {
+        if(!comp(*i, *(i - 1))) continue;
+        auto tmp = std::move(*i);
+        Iter j = i;
+        do {
+            *j = std::move(*(j - 1));
+            --j;
+        } while(j != first && comp(tmp, *(j - 1)));
+        *j = std::move(tmp);
+        moves += i - j;
+        if(moves > 8) return false;
+    }
+    return true;
+}
+
+template <class Iter, class Compare>
+constexpr void _Sort3(Iter a, Iter b, Iter c, Compare& comp) {
+    if(comp(*b, *a)) Swap(*a, *b);
+    if(comp(*c, *b)) Swap(*b, *c);
+    if(comp(*b, *a)) Swap(*a, *b);
+}
+
+// binary max-heap sort, O(n log n) whatever the input
+template <class Iter, class Compare>
+constexpr void _SiftDown(Iter first, const size_t& n, size_t i, Compare& comp) {
+    auto tmp = std::move(first[i]);
+    for(size_t c; (c = 2 * i + 1) < n; i = c) {
+        if(c + 1 < n && comp(first[c], first[c + 1])) ++c;
+        if(!comp(tmp, first[c])) break;
+        first[i] = std::move(first[c]);
+    }
+    first[i] = std::move(tmp);
+}
+
+template <class Iter, class Compare>
+constexpr void HeapSort(Iter first, Iter last, Compare comp) {
+    size_t n = last - first;
+    for(size_t i = n / 2; i-- > 0; ) _SiftDown(first, n, i, comp);
+    while(n > 1) {
+        Swap(first[0], first[--n]);
+        _SiftDown(first, n, 0, comp);
+    }
+}
+
+// partitions around the pivot *first: [first, pivot) < pivot <= (pivot, last)
+// already is set when no element had to move
+template <class Iter, class Compare>
+constexpr Iter _PartitionRight(Iter first, Iter last, Compare& comp, bool& already) {
+    auto pivot = std::move(*first);
+    Iter left = first, right = last;
+    // the median of three left an element >= pivot to stop this scan
+    while(comp(*++left, pivot)) { }
+    // nothing stops the scan from the right if no element before left was smaller
+    if(left - 1 == first) {
+        while(left < right && !comp(*--right, pivot)) { }
+    }
+    else while(!comp(*--right, pivot)) { }
+    already = !(left < right);
+    while(left < right) {
+        Swap(*left, *right);
+        while(comp(*++left, pivot)) { }
+        while(!comp(*--right, pivot)) { }
+    }
+    Iter pos = left - 1;
+    *first = std::move(*pos);
+    *pos = std::move(pivot);
+    return pos;
+}
+
+// partitions around *first with the elements equal to it on the left: [first, pivot] <= pivot < (pivot, last)
+// used when the pivot equals the element before the range, then the left part is all equal and done
+template <class Iter, class Compare>
+constexpr Iter _PartitionLeft(Iter first, Iter last, Compare& comp) {
+    auto pivot = std::move(*first);
+    Iter left = first, right = last;
+    while(comp(pivot, *--right)) { }
+    if(right + 1 == last) {
+        while(left < right && !comp(pivot, *++left)) { }
+    }
+    else while(!comp(pivot, *++left)) { }
+    while(left < right) {
+        Swap(*left, *right);
+        while(comp(pivot, *--right)) { }
+        while(!comp(pivot, *++left)) { }
+    }
+    *first = std::move(*right);
+    *right = std::move(pivot);
+    return right;
+}
+
+// swaps a few elements of a badly split part so the next pivots see a different sample
+template <class Iter>
+constexpr void _BreakPatterns(Iter first, Iter last) {
+    size_t n = last - first, q = n / 4;
+    if(n < 24) return;
+    Swap(first[0], first[q]);
+    Swap(last[-1], last[-(ptrdiff_t)q]);
+    if(n > 128) {
+        Swap(first[1], first[q + 1]);
+        Swap(first[2], first[q + 2]);
+        Swap(last[-2], last[-(ptrdiff_t)q - 1]);
+        Swap(last[-3], last[-(ptrdiff_t)q - 2]);
+    }
+}
+
+// leftmost: no element before the range belongs to it, otherwise first[-1] is no greater than any element
+template <class Iter, class Compare>
+constexpr void _PdqSort(Iter first, Iter last, Compare& comp, int bad_allowed, bool leftmost) {
+    while(true) {
+        size_t n = last - first;
+        if(n < 24) {
+            if(leftmost) InsertionSort(first, last, comp);
+            else _UnguardedInsertionSort(first, last, comp);
+            return;
+        }
+        // pivot to *first: median of three, or the median of three medians on larger ranges
+        size_t half = n / 2;
+        if(n > 128) {
+            _Sort3(first, first + half, last - 1, comp);
+            _Sort3(first + 1, first + (half - 1), last - 2, comp);
+            _Sort3(first + 2, first + (half + 1), last - 3, comp);
+            _Sort3(first + (half - 1), first + half, first + (half + 1), comp);
+            Swap(*first, first[half]);
+        }
+        else _Sort3(first + half, first, last - 1, comp);
+
+        // many equal elements: the ones equal to the pivot are already in place
+        if(!leftmost && !comp(first[-1], *first)) {
+            first = _PartitionLeft(first, last, comp) + 1;
+            continue;
+        }
+
+        bool already = false;
+        Iter pivot = _PartitionRight(first, last, comp, already);
+        size_t left_n = pivot - first, right_n = last - (pivot + 1);
+        if(left_n < n / 8 || right_n < n / 8) {
+            // bad split: heap sort after too many, otherwise shuffle the sample
+            if(--bad_allowed == 0) {
+                HeapSort(first, last, comp);
+                return;
+            }
+            _BreakPatterns(first, pivot);
+            _BreakPatterns(pivot + 1, last);
+        }
+        // a range that needed no swaps is likely sorted, check cheaply
+        else if(already && _PartialInsertionSort(first, pivot, comp) && _PartialInsertionSort(pivot + 1, last, comp)) return;
+
+        // both parts hold at least n / 8 unless the bad split budget is spent, so the recursion is O(log n) deep
+        _PdqSort(first, pivot, comp, bad_allowed, leftmost);
+        first = pivot + 1;
+        leftmost = false;
+    }
+}
+
+// pattern defeating quicksort (Orson Peters): quicksort with a median of three (or ninther) pivot,
+// linear on sorted and reversed ranges and on runs of equal keys, heap sort when splits keep going bad
+// not stable, no allocation
+template <class Iter, class Compare>
+constexpr void Sort(Iter first, Iter last, Compare comp) {
+    size_t n = last - first;
+    int log2 = 0;
+    while(n > 1) {
+        n >>= 1;
+        ++log2;
+    }
+    _PdqSort(first, last, comp, log2 + 1, true);
+}
+
+template <class Iter>
+constexpr void Sort(Iter first, Iter last) { Sort(first, last, Less()); }
+
+
+// merges sorted [first1, last1) and [first2, last2) into out, taking ties from the first range
+template <class Iter1, class Iter2, class Out, class Compare>
+constexpr Out Merge(Iter1 first1, Iter1 last1, Iter2 first2, Iter2 last2, Out out, Compare comp) {
+    while(first1 != last1 && first2 != last2) {
+        if(comp(*first2, *first1)) *out++ = std::move(*first2++);
+        else *out++ = std::move(*first1++);
+    }
+    while(first1 != last1) *out++ = std::move(*first1++);
+    while(first2 != last2) *out++ = std::move(*first2++);
+    return out;
+}
+
+// stable merge sort, buffer points to at least last - first assignable elements (their values are overwritten)
+// runs of 16 are insertion sorted, then merged back and forth between the range and the buffer
+template <class Iter, class Buffer, class Compare>
+constexpr void StableSort(Iter first, Iter last, Buffer buffer, Compare comp) {
+    const size_t RUN = 16, n = last - first;
+    for(size_t i = 0; i < n; i += RUN) InsertionSort(first + i, first + Min(i + RUN, n), comp);
+    bool in_buffer = false;
+    for(size_t width = RUN; width < n; width *= 2) {
+        for(size_t i = 0; i < n; i += 2 * width) {
+            size_t mid = Min(i + width, n), end = Min(i + 2 * width, n);
+            if(in_buffer) Merge(buffer + i, buffer + mid, buffer + mid, buffer + end, first + i, comp);
+            else Merge(first + i, first + mid, first + mid, first + end, buffer + i, comp);
+        }
+        in_buffer = !in_buffer;
+    }
+    if(in_buffer) for(size_t i = 0; i < n; ++i) first[i] = std::move(buffer[i]);
+}
+
+template <class Iter, class Buffer>
+constexpr void StableSort(Iter first, Iter last, Buffer buffer) { StableSort(first, last, buffer, Less()); }
@@ -1,5 +1,7 @@
 // allocator: http://www.josuttis.com/cppcode/allocator.html
 
+#pragma once
+
 #include <limits>
 #include <stdexcept>
 #include <new>
@@ -11,6 +13,8 @@ class _Allocator {
 public:
     _Allocator() { }
     _Allocator(const _Allocator&) { }
+    // declared with the copy constructor, an implicit one is deprecated
+    _Allocator& operator=(const _Allocator&) = default;
     template <class U>
     _Allocator(const _Allocator<U>&) { }
     ~_Allocator() { }
@@ -0,0 +1,297 @@
+// binary archive: snapshot containers to a file descriptor, load them back from a memory mapped file
+//
+// layout (native byte order and sizes, meant for restoring on the machine that wrote it):
+//   header   "STLA", u16 version, u16 byte order mark
+//   scalar   sizeof(T) raw bytes (any trivially copyable T)
+//   vector   u64 count, then (trivially copyable T) padding to alignof(T) and the elements as one block
+//                           (otherwise) every element in turn
+//   string   u64 length, padding to alignof(T), the chars and a terminator
+// padding is relative to the start of the archive, so a mapped archive can be viewed in place
+
+#pragma once
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "String.h"
+#include "Vector.h"
+#include "View.h"
+
+
+// raw bytes of these can be written and mapped back (pointers would dangle)
+template <class T>
+using _IsArchivable = std::integral_constant<bool, std::is_trivially_copyable<T>::value && !std::is_pointer<T>::value>;
+
+struct _ArchiveHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t byte_order;
+};
+
+static const _ArchiveHeader _ARCHIVE_HEADER = {{'S', 'T', 'L', 'A'}, 1, 0x0102};
+
+
+// buffered writer, small items are gathered and large blocks go to the descriptor in one write
+// the descriptor stays owned by the caller
+// usage:
+//   ArchiveWriter w(fd);
+//   w.write(keys).write(names);   // Vector<int>, Vector<String>
+//   w.flush();
+class ArchiveWriter {
+public:
+    // blocks at least this large bypass the buffer
+    static constexpr size_t BUFFER = 1 << 16;
+
+protected:
+    int _fd;
+    Vector<char> _buf;
+    size_t _used;
+    // bytes since the start of the archive, for padding
+    uint64_t _offset;
+
+    void _write_fd(const char* p, size_t n) {
+        while(n > 0) {
+            ssize_t w = ::write(_fd, p, n);
+            if(w < 0) {
+                if(errno == EINTR) continue;
+                throw std::system_error(errno, std::generic_category(), "archive write");
+            }
+            p += w;
+            n -= w;
+        }
+    }
+
+public:
+    explicit ArchiveWriter(const int& fd): _fd{fd}, _buf(BUFFER, 0), _used{0}, _offset{0} {
+        write_bytes(&_ARCHIVE_HEADER, sizeof(_ARCHIVE_HEADER));
+    }
+    ArchiveWriter(const ArchiveWriter&) = delete;
+    ArchiveWriter& operator=(const ArchiveWriter&) = delete;
+    // flush() explicitly to see errors, the destructor cannot report them
+    ~ArchiveWriter() {
+        try { flush(); } catch(...) { }
+    }
+
+    uint64_t offset() const { return _offset; }
+
+    void flush() {
+        _write_fd(_buf.data(), _used);
+        _used = 0;
+    }
+
+    void write_bytes(const void* p, const size_t& n) {
+        if(_used + n > BUFFER) flush();
+        if(n >= BUFFER) _write_fd((const char*)p, n);
+        else {
+            memcpy(_buf.data() + _used, p, n);
+            _used += n;
+        }
+        _offset += n;
+    }
+    void write_size(const uint64_t& n) { write_bytes(&n, sizeof(n)); }
+    // zero bytes up to a multiple of alignment (a power of two)
+    void align(const size_t& alignment) {
+        static const char zeros[64] = {};
+        size_t pad = (alignment - _offset % alignment) % alignment;
+        while(pad > 0) {
+            size_t n = Min(pad, sizeof(zeros));
+            write_bytes(zeros, n);
+            pad -= n;
+        }
+    }
+
+    // any type with a Save overload (found by argument dependent lookup for user types)
+    template <class T>
+    ArchiveWriter& write(const T& x);
+};
+
+
+// reader over a whole archive in memory, mapped from a file or borrowed from the caller
+// views and c strings handed out point into the archive and live as long as the reader
+class ArchiveReader {
+protected:
+    const char *_base;
+    size_t _size;
+    size_t _offset;
+    // munmap on destruction
+    bool _mapped;
+
+    void _map(const int& fd) {
+        struct stat st;
+        if(fstat(fd, &st) < 0) throw std::system_error(errno, std::generic_category(), "archive stat");
+        _size = st.st_size;
+        if(_size < sizeof(_ArchiveHeader)) throw std::invalid_argument("not an archive");
+        void *p = mmap(NULL, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(p == MAP_FAILED) throw std::system_error(errno, std::generic_category(), "archive mmap");
+        _base = (const char*)p;
+        _mapped = true;
+    }
+    void _check_header() {
+        _ArchiveHeader h;
+        read_bytes(&h, sizeof(h));
+        if(memcmp(h.magic, _ARCHIVE_HEADER.magic, sizeof(h.magic)) != 0 || h.version != _ARCHIVE_HEADER.version) {
+            throw std::invalid_argument("not an archive");
+        }
+        if(h.byte_order != _ARCHIVE_HEADER.byte_order) throw std::invalid_argument("archive written with another byte order");
+    }
+    void _unmap() {
+        if(_mapped) munmap((void*)_base, _size);
+        _base = NULL;
+        _size = _offset = 0;
+        _mapped = false;
+    }
+
+public:
+    // maps the file at path (the archive must start at its first byte)
+    explicit ArchiveReader(const char* path): _base{NULL}, _size{0}, _offset{0}, _mapped{false} {
+        int fd = open(path, O_RDONLY);
+        if(fd < 0) throw std::system_error(errno, std::generic_category(), "archive open");
+        try { _map(fd); } catch(...) {
+            close(fd);
+            throw;
+        }
+        close(fd);
+        try { _check_header(); } catch(...) {
+            _unmap();
+            throw;
+        }
+    }
+    // borrows size bytes at data, which must stay alive and be aligned like malloc memory
+    ArchiveReader(const void* data, const size_t& size): _base{(const char*)data}, _size{size}, _offset{0}, _mapped{false} {
+        _check_header();
+    }
+    ArchiveReader(const ArchiveReader&) = delete;
+    ArchiveReader& operator=(const ArchiveReader&) = delete;
+    ArchiveReader(ArchiveReader&& r): _base{r._base}, _size{r._size}, _offset{r._offset}, _mapped{r._mapped} {
+        r._base = NULL;
+        r._size = r._offset = 0;
+        r._mapped = false;
+    }
+    ~ArchiveReader() { _unmap(); }
+
+    size_t offset() const { return _offset; }
+    size_t remaining() const { return _size - _offset; }
+
+    // n bytes in place, bounds checked
+    const void* take(const size_t& n) {
+        if(n > _size - _offset) throw std::out_of_range("archive truncated");
+        const char *p = _base + _offset;
+        _offset += n;
+        return p;
+    }
+    void read_bytes(void* p, const size_t& n) { memcpy(p, take(n), n); }
+    uint64_t read_size() {
+        uint64_t n;
+        read_bytes(&n, sizeof(n));
+        return n;
+    }
+    void align(const size_t& alignment) { take((alignment - _offset % alignment) % alignment); }
+
+    // owned copies, any type with a Load overload
+    template <class T>
+    ArchiveReader& read(T& x);
+    template <class T>
+    T read() {
+        T x;
+        read(x);
+        return x;
+    }
+
+    // zero copy views of a vector of trivially copyable T or a string
+    // a vector of vectors is walked as read_size() followed by that many views
+    template <class T>
+    VectorView<T> view_vector() {
+        static_assert(_IsArchivable<T>::value, "only vectors of trivially copyable items can be viewed");
+        uint64_t n = read_size();
+        if(n > remaining() / sizeof(T)) throw std::out_of_range("archive truncated");
+        align(alignof(T));
+        const T *p = (const T*)take(n * sizeof(T));
+        if((uintptr_t)p % alignof(T) != 0) throw std::invalid_argument("archive memory is misaligned");
+        return VectorView<T>(p, n);
+    }
+    StringView view_string() {
+        uint64_t n = read_size();
+        if(n >= remaining()) throw std::out_of_range("archive truncated");
+        const char *p = (const char*)take(n + 1);
+        if(p[n] != '\0') throw std::invalid_argument("archive string is not terminated");
+        return StringView(p, n);
+    }
+};
+
+
+// Save / Load overloads, add more for your own types next to them
+
+template <class T, class = std::enable_if_t<_IsArchivable<T>::value>>
+void Save(ArchiveWriter& w, const T& x) { w.write_bytes(&x, sizeof(T)); }
+
+template <class T, class = std::enable_if_t<_IsArchivable<T>::value>>
+void Load(ArchiveReader& r, T& x) { r.read_bytes(&x, sizeof(T)); }
+
+template <class T, class Alloc>
+void Save(ArchiveWriter& w, const _String<T, Alloc>& s) {
+    w.write_size(s.length());
+    w.align(alignof(T));
+    w.write_bytes(s.c_str(), (s.length() + 1) * sizeof(T));
+}
+
+template <class T, class Alloc>
+void Load(ArchiveReader& r, _String<T, Alloc>& s) {
+    uint64_t n = r.read_size();
+    r.align(alignof(T));
+    if(n >= r.remaining() / sizeof(T)) throw std::out_of_range("archive truncated");
+    const T *p = (const T*)r.take((n + 1) * sizeof(T));
+    if(p[n] != (T)'\0') throw std::invalid_argument("archive string is not terminated");
+    s = _String<T, Alloc>(p);
+}
+
+template <class T, class Alloc>
+void Save(ArchiveWriter& w, const Vector<T, Alloc>& v) {
+    w.write_size(v.size());
+    if constexpr (_IsArchivable<T>::value) {
+        w.align(alignof(T));
+        w.write_bytes(v.data(), v.size() * sizeof(T));
+    }
+    else for(size_t i = 0; i < v.size(); ++i) Save(w, v.at_unchecked(i));
+}
+
+template <class T, class Alloc>
+void Load(ArchiveReader& r, Vector<T, Alloc>& v) {
+    uint64_t n = r.read_size();
+    if constexpr (_IsArchivable<T>::value) {
+        if(n > r.remaining() / sizeof(T)) throw std::out_of_range("archive truncated");
+        r.align(alignof(T));
+        // one allocation and one memcpy
+        const T *p = (const T*)r.take(n * sizeof(T));
+        v = Vector<T, Alloc>(p, p + n);
+    } else {
+        Vector<T, Alloc> ret;
+        ret.reserve(n);
+        for(uint64_t i = 0; i < n; ++i) {
+            T x;
+            Load(r, x);
+            ret.push_back(std::move(x));
+        }
+        v = std::move(ret);
+    }
+}
+
+template <class T>
+ArchiveWriter& ArchiveWriter::write(const T& x) {
+    Save(*this, x);
+    return *this;
+}
+
+template <class T>
+ArchiveReader& ArchiveReader::read(T& x) {
+    Load(*this, x);
+    return *this;
+}
@@ -0,0 +1,462 @@
+// coroutines (C++20): lazy generators, awaitable tasks, a thread pool to run them on
+// and bounded channels between them, senders wait while a channel is full (backpressure)
+
+#pragma once
+
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include "Deque.h"
+#include "Vector.h"
+
+
+// synchronous, lazy sequence: the body runs up to the next co_yield whenever the iterator advances
+// usage:
+//   Generator<int> Count(int n) { for(int i = 0; i < n; ++i) co_yield i; }
+//   for(int i : Count(3)) ...
+template <class T>
+class Generator {
+public:
+    struct promise_type {
+        // the yielded object lives in the coroutine frame until the next resume
+        const T* _value;
+        std::exception_ptr _error;
+
+        Generator get_return_object() { return Generator(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        std::suspend_always yield_value(const T& value) noexcept {
+            _value = &value;
+            return {};
+        }
+        void return_void() { }
+        void unhandled_exception() { _error = std::current_exception(); }
+    };
+
+    // input iterator, end() is a sentinel
+    class Iterator {
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const T* pointer;
+        typedef const T& reference;
+
+    protected:
+        std::coroutine_handle<promise_type> _h;
+
+    public:
+        Iterator(std::coroutine_handle<promise_type> h = {}): _h{h} { }
+
+        const T& operator*() const { return *_h.promise()._value; }
+        const T* operator->() const { return _h.promise()._value; }
+        Iterator& operator++() {
+            _advance(_h);
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+
+        bool operator==(const Iterator& it) const { return _done() == it._done(); }
+        bool operator!=(const Iterator& it) const { return !(*this == it); }
+        bool _done() const { return !_h || _h.done(); }
+    };
+
+protected:
+    std::coroutine_handle<promise_type> _h;
+
+    explicit Generator(std::coroutine_handle<promise_type> h): _h{h} { }
+
+    // resume, exceptions thrown by the body surface here
+    static void _advance(std::coroutine_handle<promise_type> h) {
+        h.resume();
+        if(h.promise()._error) std::rethrow_exception(std::exchange(h.promise()._error, nullptr));
+    }
+
+public:
+    Generator(const Generator&) = delete;
+    Generator& operator=(const Generator&) = delete;
+    Generator(Generator&& g): _h{std::exchange(g._h, nullptr)} { }
+    Generator& operator=(Generator&& g) {
+        if(&g != this) {
+            if(_h) _h.destroy();
+            _h = std::exchange(g._h, nullptr);
+        }
+        return *this;
+    }
+    ~Generator() {
+        if(_h) _h.destroy();
+    }
+
+    // runs to the first co_yield, iterate once
+    Iterator begin() {
+        if(_h && !_h.done()) _advance(_h);
+        return Iterator(_h);
+    }
+    Iterator end() { return Iterator(); }
+};
+
+
+// lazy coroutine producing a T, started when it is awaited (or spawned on a ThreadPool)
+// the awaiting coroutine resumes right where the task finishes, on the same thread
+// usage:
+//   Task<int> Answer() { co_return 42; }
+//   Task<void> Run() { int x = co_await Answer(); ... }
+template <class T = void>
+class Task;
+
+// result slot, return_value / return_void decide which one a promise has
+template <class T>
+struct _TaskResult {
+    std::optional<T> _value;
+    void return_value(T value) { _value.emplace(std::move(value)); }
+    T _take() { return std::move(*_value); }
+};
+
+template <>
+struct _TaskResult<void> {
+    void return_void() { }
+    void _take() { }
+};
+
+template <class T>
+class Task {
+public:
+    struct promise_type : _TaskResult<T> {
+        std::coroutine_handle<> _continuation;
+        std::exception_ptr _error;
+
+        // hands control to whoever awaited the task (symmetric transfer, no stack growth)
+        struct _Final {
+            bool await_ready() noexcept { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+                std::coroutine_handle<> next = h.promise()._continuation;
+                return next ? next : std::noop_coroutine();
+            }
+            void await_resume() noexcept { }
+        };
+
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        _Final final_suspend() noexcept { return {}; }
+        void unhandled_exception() { _error = std::current_exception(); }
+    };
+
+protected:
+    std::coroutine_handle<promise_type> _h;
+
+    explicit Task(std::coroutine_handle<promise_type> h): _h{h} { }
+
+public:
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    Task(Task&& t): _h{std::exchange(t._h, nullptr)} { }
+    Task& operator=(Task&& t) {
+        if(&t != this) {
+            if(_h) _h.destroy();
+            _h = std::exchange(t._h, nullptr);
+        }
+        return *this;
+    }
+    ~Task() {
+        if(_h) _h.destroy();
+    }
+
+    // awaitable
+    bool await_ready() const noexcept { return !_h || _h.done(); }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        _h.promise()._continuation = awaiting;
+        return _h;
+    }
+    T await_resume() {
+        if(!_h) throw std::logic_error("task has no coroutine");
+        if(_h.promise()._error) std::rethrow_exception(_h.promise()._error);
+        return _h.promise()._take();
+    }
+};
+
+
+// fixed set of worker threads resuming coroutines from one queue
+// usage:
+//   ThreadPool pool(4);
+//   pool.spawn(Stage(...));   // Task<void>, runs on a worker
+//   pool.wait();              // every spawned task finished, the first exception is rethrown
+class ThreadPool {
+protected:
+    // started without waiting on anyone, destroys itself at the end
+    struct _Detached {
+        struct promise_type {
+            _Detached get_return_object() { return _Detached{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() { }
+            void unhandled_exception() { std::terminate(); }
+        };
+        std::coroutine_handle<promise_type> _h;
+    };
+
+    Vector<std::thread> _threads;
+    Deque<std::coroutine_handle<>> _queue;
+    std::mutex _mutex;
+    std::condition_variable _ready;
+    std::condition_variable _idle;
+    // spawned tasks not finished yet
+    size_t _pending;
+    bool _stop;
+    std::exception_ptr _error;
+
+    void _work() {
+        for(;;) {
+            std::coroutine_handle<> h;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _ready.wait(lock, [this] { return _stop || !_queue.empty(); });
+                if(_queue.empty()) return;
+                h = _queue.front();
+                _queue.pop_front();
+            }
+            h.resume();
+        }
+    }
+    void _finish(std::exception_ptr error) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if(error && !_error) _error = error;
+        if(--_pending == 0) _idle.notify_all();
+    }
+    static _Detached _run(ThreadPool* pool, Task<void> task) {
+        std::exception_ptr error;
+        try { co_await task; } catch(...) { error = std::current_exception(); }
+        pool->_finish(error);
+    }
+
+public:
+    explicit ThreadPool(const size_t& threads = std::thread::hardware_concurrency()): _pending{0}, _stop{false} {
+        size_t n = threads == 0 ? 1 : threads;
+        _threads.reserve(n);
+        for(size_t i = 0; i < n; ++i) _threads.push_back(std::thread([this] { _work(); }));
+    }
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    // finishes the queued work, call wait() first so no task is left suspended
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _ready.notify_all();
+        for(size_t i = 0; i < _threads.size(); ++i) _threads.at_unchecked(i).join();
+    }
+
+    size_t size() const { return _threads.size(); }
+
+    // resume h on a worker
+    void post(std::coroutine_handle<> h) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _queue.push_back(h);
+        }
+        _ready.notify_one();
+    }
+    // co_await pool.schedule() continues the coroutine on a worker
+    auto schedule() {
+        struct _Schedule {
+            ThreadPool *_pool;
+            bool await_ready() noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> h) { _pool->post(h); }
+            void await_resume() noexcept { }
+        };
+        return _Schedule{this};
+    }
+
+    void spawn(Task<void> task) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            ++_pending;
+        }
+        post(_run(this, std::move(task))._h);
+    }
+    // blocks until every spawned task has finished
+    void wait() {
+        std::exception_ptr error;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _idle.wait(lock, [this] { return _pending == 0; });
+            error = std::exchange(_error, nullptr);
+        }
+        if(error) std::rethrow_exception(error);
+    }
+};
+
+
+// bounded multi producer / multi consumer queue between coroutines
+// a full channel suspends senders, an empty one suspends receivers, both are resumed on the pool
+// the channel closes once every producer called close(), receivers then drain what is left
+// a consumer that stops early calls cancel(), so producers blocked on a full channel see false instead of waiting forever
+// usage:
+//   Channel<LineBatch> ch(pool, 8);
+//   if(!co_await ch.send(std::move(batch))) ...       // closed or cancelled
+//   while(co_await ch.receive(batch)) ...
+template <class T>
+class Channel {
+protected:
+    struct _Sender {
+        Channel *_ch;
+        T _value;
+        bool _ok;
+        std::coroutine_handle<> _h;
+
+        bool await_ready() noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> h) { return _ch->_send(this, h); }
+        bool await_resume() noexcept { return _ok; }
+    };
+    struct _Receiver {
+        Channel *_ch;
+        T *_out;
+        bool _ok;
+        std::coroutine_handle<> _h;
+
+        bool await_ready() noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> h) { return _ch->_receive(this, h); }
+        bool await_resume() noexcept { return _ok; }
+    };
+
+    ThreadPool &_pool;
+    std::mutex _mutex;
+    Deque<T> _items;
+    size_t _capacity;
+    size_t _producers;
+    bool _closed;
+    // suspended senders keep their value in the awaiter until there is room
+    Deque<_Sender*> _senders;
+    Deque<_Receiver*> _receivers;
+
+    // the await_suspend bodies, true keeps the coroutine suspended
+    // once a waiter is queued another thread may resume it, so nothing here touches it after unlocking
+    bool _send(_Sender* s, std::coroutine_handle<> h) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        s->_ok = !_closed;
+        if(_closed) return false;
+        if(!_receivers.empty()) {
+            // straight to a waiting receiver
+            _Receiver *r = _receivers.front();
+            _receivers.pop_front();
+            *r->_out = std::move(s->_value);
+            r->_ok = true;
+            lock.unlock();
+            _pool.post(r->_h);
+            return false;
+        }
+        if(_items.size() < _capacity) {
+            _items.push_back(std::move(s->_value));
+            return false;
+        }
+        s->_h = h;
+        _senders.push_back(s);
+        return true;
+    }
+    bool _receive(_Receiver* r, std::coroutine_handle<> h) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _Sender *s = NULL;
+        if(!_items.empty()) {
+            *r->_out = std::move(_items.front());
+            _items.pop_front();
+            // room for one waiting sender
+            if(!_senders.empty()) {
+                s = _senders.front();
+                _senders.pop_front();
+                _items.push_back(std::move(s->_value));
+            }
+        } else if(!_senders.empty()) {
+            // unbuffered hand over
+            s = _senders.front();
+            _senders.pop_front();
+            *r->_out = std::move(s->_value);
+        } else if(_closed) {
+            r->_ok = false;
+            return false;
+        } else {
+            r->_h = h;
+            _receivers.push_back(r);
+            return true;
+        }
+        r->_ok = true;
+        lock.unlock();
+        if(s != NULL) _pool.post(s->_h);
+        return false;
+    }
+
+    // every waiter resumes with false (nobody is left to serve it)
+    void _release(Deque<_Sender*>& senders, Deque<_Receiver*>& receivers) {
+        for(; !senders.empty(); senders.pop_front()) {
+            senders.front()->_ok = false;
+            _pool.post(senders.front()->_h);
+        }
+        for(; !receivers.empty(); receivers.pop_front()) {
+            receivers.front()->_ok = false;
+            _pool.post(receivers.front()->_h);
+        }
+    }
+
+public:
+    // capacity 0 hands every item from a sender to a receiver directly
+    Channel(ThreadPool& pool, const size_t& capacity, const size_t& producers = 1):
+        _pool(pool), _capacity{capacity}, _producers{producers}, _closed{producers == 0} { }
+    Channel(const Channel&) = delete;
+    Channel& operator=(const Channel&) = delete;
+
+    // co_await, false if the channel is closed (the value is dropped)
+    _Sender send(T value) { return _Sender{this, std::move(value), false, {}}; }
+    // co_await, false once the channel is closed and drained
+    _Receiver receive(T& out) { return _Receiver{this, &out, false, {}}; }
+
+    // called once by every producer
+    void close() {
+        Deque<_Sender*> senders;
+        Deque<_Receiver*> receivers;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if(_closed || --_producers > 0) return;
+            _closed = true;
+            senders = std::move(_senders);
+            receivers = std::move(_receivers);
+        }
+        _release(senders, receivers);
+    }
+    // called by a consumer that stops reading (e.g. it failed): the buffered items are dropped,
+    // pending and later sends return false, receivers see the channel closed and drained
+    void cancel() {
+        Deque<T> items;
+        Deque<_Sender*> senders;
+        Deque<_Receiver*> receivers;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _closed = true;
+            items = std::move(_items);
+            senders = std::move(_senders);
+            receivers = std::move(_receivers);
+        }
+        _release(senders, receivers);
+    }
+
+    size_t capacity() const { return _capacity; }
+};
+
+// closes a producer's share of a channel when its stage ends, by returning or by throwing
+// usage:
+//   ChannelCloser<String> closer(out);
+template <class T>
+class ChannelCloser {
+protected:
+    Channel<T>& _ch;
+
+public:
+    explicit ChannelCloser(Channel<T>& ch): _ch(ch) { }
+    ChannelCloser(const ChannelCloser&) = delete;
+    ChannelCloser& operator=(const ChannelCloser&) = delete;
+    ~ChannelCloser() { _ch.close(); }
+};
@@ -0,0 +1,215 @@
+// counting allocator: wraps any allocator and records allocation statistics
+
+#pragma once
+
+#include <atomic>
+#include <ostream>
+
+#include "Allocator.h"
+
+
+// statistics shared by every allocator bound to it (thread-safe)
+class AllocStats {
+public:
+    // bucket i counts requests of [2^i, 2^(i+1)) bytes
+    static const size_t BUCKETS = 8 * sizeof(size_t);
+
+protected:
+    const char *_name;
+    std::atomic<size_t> _allocations;
+    std::atomic<size_t> _deallocations;
+    // grow paths: a bigger block requested while the same allocator still holds one
+    std::atomic<size_t> _reallocations;
+    std::atomic<size_t> _bytes;
+    std::atomic<size_t> _live;
+    std::atomic<size_t> _peak;
+    std::atomic<size_t> _histogram[BUCKETS];
+
+    static size_t _bucket(size_t bytes) {
+        size_t i = 0;
+        while(bytes >>= 1) ++i;
+        return i;
+    }
+
+public:
+    AllocStats(const char* name = "default"): _name{name} { reset(); }
+    // counters are shared by address, never copied
+    AllocStats(const AllocStats&) = delete;
+    AllocStats& operator=(const AllocStats&) = delete;
+
+    void reset() {
+        _allocations = _deallocations = _reallocations = 0;
+        _bytes = _live = _peak = 0;
+        for(size_t i = 0; i < BUCKETS; ++i) _histogram[i] = 0;
+    }
+
+    void record_allocate(const size_t& bytes, const bool& realloc) {
+        ++_allocations;
+        if(realloc) ++_reallocations;
+        _bytes += bytes;
+        ++_histogram[_bucket(bytes)];
+        size_t live = _live += bytes;
+        // raise peak if another thread has not raised it further already
+        size_t peak = _peak.load();
+        while(live > peak && !_peak.compare_exchange_weak(peak, live)) { }
+    }
+    void record_deallocate(const size_t& bytes) {
+        ++_deallocations;
+        _live -= bytes;
+    }
+
+    const char* name() const { return _name; }
+    size_t allocations() const { return _allocations; }
+    size_t deallocations() const { return _deallocations; }
+    size_t reallocations() const { return _reallocations; }
+    size_t bytes_allocated() const { return _bytes; }
+    size_t live_bytes() const { return _live; }
+    size_t peak_bytes() const { return _peak; }
+    size_t histogram(const size_t& bucket) const { return _histogram[bucket]; }
+
+    // json object, histogram keyed by the lower bound of each non-empty bucket
+    void dump(std::ostream& os) const {
+        os << "{\"name\": \"";
+        // the name as a json string: quotes and backslashes escaped, control chars as \u00XX
+        for(const char *c = _name; *c; ++c) {
+            if(*c == '"' || *c == '\\') os << '\\' << *c;
+            else if((unsigned char)*c < 0x20) os << "\\u00" << "0123456789abcdef"[*c >> 4] << "0123456789abcdef"[*c & 0xf];
+            else os << *c;
+        }
+        os << "\""
+           << ", \"allocations\": " << allocations()
+           << ", \"deallocations\": " << deallocations()
+           << ", \"reallocations\": " << reallocations()
+           << ", \"bytes_allocated\": " << bytes_allocated()
+           << ", \"live_bytes\": " << live_bytes()
+           << ", \"peak_bytes\": " << peak_bytes()
+           << ", \"histogram\": {";
+        bool first = true;
+        for(size_t i = 0; i < BUCKETS; ++i) {
+            if(_histogram[i] == 0) continue;
+            os << (first ? "" : ", ") << "\"" << ((size_t)1 << i) << "\": " << _histogram[i];
+            first = false;
+        }
+        os << "}}";
+    }
+};
+
+// stats used by allocators constructed outside of any AllocTag scope
+inline AllocStats& global_alloc_stats() {
+    static AllocStats stats("global");
+    return stats;
+}
+
+
+// scoped tag: counting allocators default-constructed in this scope (on this thread)
+// record into the given stats, so one container instance can be tracked on its own
+// usage:
+//   AllocStats stats("requests");
+//   { AllocTag tag(stats); Vector<int, _CountingAllocator<int>> v; ... }
+class AllocTag {
+protected:
+    AllocStats *_prev;
+
+    static AllocStats*& _current() {
+        static thread_local AllocStats *cur = NULL;
+        return cur;
+    }
+
+public:
+    explicit AllocTag(AllocStats& stats): _prev{_current()} { _current() = &stats; }
+    AllocTag(const AllocTag&) = delete;
+    ~AllocTag() { _current() = _prev; }
+
+    static AllocStats& current() { return _current() != NULL ? *_current() : global_alloc_stats(); }
+};
+
+
+template <class T, class Alloc = _Allocator<T>>
+class _CountingAllocator {
+    template <class U, class A> friend class _CountingAllocator;
+
+protected:
+    Alloc _alloc;
+    AllocStats *_stats;
+    // blocks held by this instance, used to tell reallocations from fresh allocations
+    size_t _live_blocks;
+    size_t _last_bytes;
+
+public:
+    // bind to the innermost AllocTag (or the global stats)
+    _CountingAllocator(): _stats{&AllocTag::current()}, _live_blocks{0}, _last_bytes{0} { }
+    explicit _CountingAllocator(AllocStats& stats): _stats{&stats}, _live_blocks{0}, _last_bytes{0} { }
+    // copies share the stats but own no blocks yet
+    _CountingAllocator(const _CountingAllocator& a):
+        _alloc{a._alloc}, _stats{a._stats}, _live_blocks{0}, _last_bytes{0} { }
+    // a move follows a transferred buffer (container move), the blocks go with it
+    _CountingAllocator(_CountingAllocator&& a):
+        _alloc{a._alloc}, _stats{a._stats}, _live_blocks{a._live_blocks}, _last_bytes{a._last_bytes} {
+        a._live_blocks = a._last_bytes = 0;
+    }
+    template <class U, class A>
+    _CountingAllocator(const _CountingAllocator<U, A>& a):
+        _alloc(a._alloc), _stats{a._stats}, _live_blocks{0}, _last_bytes{0} { }
+    ~_CountingAllocator() { }
+
+    // copy assign shares the stats, this instance keeps its own blocks
+    _CountingAllocator& operator=(const _CountingAllocator& a) {
+        _alloc = a._alloc;
+        _stats = a._stats;
+        return *this;
+    }
+    // move assign follows a transferred buffer (container move assign, swap)
+    _CountingAllocator& operator=(_CountingAllocator&& a) {
+        if(&a != this) {
+            _alloc = a._alloc;
+            _stats = a._stats;
+            _live_blocks = a._live_blocks;
+            _last_bytes = a._last_bytes;
+            a._live_blocks = a._last_bytes = 0;
+        }
+        return *this;
+    }
+
+    template <class U>
+    using rebind = _CountingAllocator<U, typename Alloc::template rebind<U>>;
+
+    AllocStats& stats() const { return *_stats; }
+    const Alloc& base() const { return _alloc; }
+
+    size_t max_size() const { return _alloc.max_size(); }
+
+    T* address(T& x) const { return _alloc.address(x); }
+    const T* address(const T& x) const { return _alloc.address(x); }
+
+    T* allocate(const size_t& n, const void* hint = 0) {
+        T *ret = _alloc.allocate(n, hint);
+        // zero-sized requests are not allocations
+        if(ret == NULL) return ret;
+        size_t bytes = n * sizeof(T);
+        _stats->record_allocate(bytes, _live_blocks > 0 && bytes > _last_bytes);
+        ++_live_blocks;
+        _last_bytes = bytes;
+        return ret;
+    }
+    void deallocate(T* p, const size_t& n) {
+        _alloc.deallocate(p, n);
+        if(p == NULL) return;
+        _stats->record_deallocate(n * sizeof(T));
+        if(_live_blocks > 0) --_live_blocks;
+    }
+
+    void construct(T* p, const T& val) { _alloc.construct(p, val); }
+    void construct(T* p, T&& val) { _alloc.construct(p, std::move(val)); }
+    void destroy(T* p) { _alloc.destroy(p); }
+};
+
+// interchangeable whenever the wrapped allocators are
+template <class T1, class A1, class T2, class A2>
+bool operator==(const _CountingAllocator<T1, A1>& lhs, const _CountingAllocator<T2, A2>& rhs) {
+    return lhs.base() == rhs.base();
+}
+
+template <class T1, class A1, class T2, class A2>
+bool operator!=(const _CountingAllocator<T1, A1>& lhs, const _CountingAllocator<T2, A2>& rhs) {
+    return lhs.base() != rhs.base();
+}
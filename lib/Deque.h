@@ -0,0 +1,305 @@
+// deque: ring buffer with a power-of-two capacity, O(1) amortized push/pop at both ends
+
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "Algorithm.h"
+#include "Allocator.h"
+#include "Memory.h"
+
+
+// random access iterator over a ring buffer
+// same interface and traits as _RandomIterator, but not contiguous (the range may wrap)
+template <class T, class DifferenceType = std::ptrdiff_t>
+class _RingIterator {
+public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef std::remove_cv_t<T> value_type;
+    typedef DifferenceType difference_type;
+    typedef T* pointer;
+    typedef T& reference;
+
+protected:
+    T *_buf;
+    size_t _mask;
+    // unmasked position, so iterators compare without caring about the wrap
+    size_t _pos;
+
+public:
+    constexpr _RingIterator(T* buf = NULL, const size_t& mask = 0, const size_t& pos = 0): _buf{buf}, _mask{mask}, _pos{pos} { }
+    // Iterator converts to ConstIterator
+    template <class U, class = std::enable_if_t<!std::is_same<U, T>::value && std::is_convertible<U*, T*>::value>>
+    constexpr _RingIterator(const _RingIterator<U, DifferenceType>& it): _buf{it.buffer()}, _mask{it.mask()}, _pos{it.position()} { }
+
+    constexpr T* buffer() const { return _buf; }
+    constexpr size_t mask() const { return _mask; }
+    constexpr size_t position() const { return _pos; }
+    constexpr T* base() const { return _buf + (_pos & _mask); }
+
+    constexpr T& operator*() const { return _buf[_pos & _mask]; }
+    constexpr T* operator->() const { return base(); }
+    constexpr T& operator[](const DifferenceType diff) const { return _buf[(_pos + diff) & _mask]; }
+
+    constexpr _RingIterator& operator++() {
+        ++_pos;
+        return *this;
+    }
+    constexpr _RingIterator operator++(int) {
+        _RingIterator it(*this);
+        ++_pos;
+        return it;
+    }
+    constexpr _RingIterator& operator--() {
+        --_pos;
+        return *this;
+    }
+    constexpr _RingIterator operator--(int) {
+        _RingIterator ret(*this);
+        --_pos;
+        return ret;
+    }
+
+    constexpr _RingIterator operator+(const DifferenceType diff) const { return _RingIterator(_buf, _mask, _pos + diff); }
+    constexpr _RingIterator& operator+=(const DifferenceType diff) {
+        _pos += diff;
+        return *this;
+    }
+    constexpr _RingIterator operator-(const DifferenceType diff) const { return _RingIterator(_buf, _mask, _pos - diff); }
+    constexpr _RingIterator& operator-=(const DifferenceType diff) {
+        _pos -= diff;
+        return *this;
+    }
+};
+
+template <class T, class D>
+constexpr bool operator==(const _RingIterator<T, D>& lhs, const _RingIterator<T, D>& rhs) { return lhs.position() == rhs.position(); }
+
+template <class T, class D>
+constexpr bool operator!=(const _RingIterator<T, D>& lhs, const _RingIterator<T, D>& rhs) { return lhs.position() != rhs.position(); }
+
+template <class T, class D>
+constexpr bool operator<(const _RingIterator<T, D>& lhs, const _RingIterator<T, D>& rhs) { return lhs.position() < rhs.position(); }
+
+template <class T, class D>
+constexpr bool operator>(const _RingIterator<T, D>& lhs, const _RingIterator<T, D>& rhs) { return rhs < lhs; }
+
+template <class T, class D>
+constexpr bool operator<=(const _RingIterator<T, D>& lhs, const _RingIterator<T, D>& rhs) { return !(rhs < lhs); }
+
+template <class T, class D>
+constexpr bool operator>=(const _RingIterator<T, D>& lhs, const _RingIterator<T, D>& rhs) { return !(lhs < rhs); }
+
+template <class T, class D>
+constexpr D operator-(const _RingIterator<T, D>& lhs, const _RingIterator<T, D>& rhs) { return lhs.position() - rhs.position(); }
+
+template <class T, class D>
+constexpr _RingIterator<T, D> operator+(const typename _RingIterator<T, D>::difference_type diff, const _RingIterator<T, D>& it) { return it + diff; }
+
+
+template <class T, class _Alloc = _Allocator<T>>
+class Deque {
+public:
+    typedef _RingIterator<T> Iterator;
+    typedef _RingIterator<const T> ConstIterator;
+
+protected:
+    T* _data;
+    // power of two (or 0), so wrapping is a mask instead of a division
+    size_t _capacity;
+    size_t _head;
+    size_t _size;
+    _Alloc _alloc;
+
+    size_t _mask() const { return _capacity - 1; }
+    T* _slot(const size_t& i) const { return _data + ((_head + i) & _mask()); }
+
+    // the elements as at most two contiguous runs: [head, head + first) and [0, size - first)
+    size_t _first_run() const { return Min(_size, _capacity - _head); }
+
+    // move everything into a new buffer of new_capacity (a power of two), head back at 0
+    void _reallocate(const size_t& new_capacity) {
+        T *ret = _alloc.allocate(new_capacity);
+        if(_size > 0) {
+            size_t first = _first_run();
+            Relocate(_data + _head, first, ret, _alloc);
+            Relocate(_data, _size - first, ret + first, _alloc);
+        }
+        _alloc.deallocate(_data, _capacity);
+        _data = ret;
+        _capacity = new_capacity;
+        _head = 0;
+    }
+    void _reserve(const size_t& n) {
+        if(n <= _capacity) return;
+        size_t new_capacity = _capacity == 0 ? 8 : _capacity;
+        while(new_capacity < n) new_capacity *= 2;
+        _reallocate(new_capacity);
+    }
+    // copy from another deque, capacity rounded to a power of two
+    void _copy_from(const Deque& d) {
+        _reserve(d._size);
+        for(size_t i = 0; i < d._size; ++i) _alloc.construct(_data + i, *d._slot(i));
+        _size = d._size;
+    }
+
+public:
+    // default (no allocation)
+    Deque(): _data{NULL}, _capacity{0}, _head{0}, _size{0} { }
+    // from size
+    Deque(const size_t& size, const T& value): Deque() {
+        _reserve(size);
+        UninitializedFill(_data, size, value, _alloc);
+        _size = size;
+    }
+    // from list
+    Deque(std::initializer_list<T> l): Deque() {
+        _reserve(l.size());
+        UninitializedCopy(l.begin(), l.end(), _data, _alloc);
+        _size = l.size();
+    }
+    // copy
+    Deque(const Deque& d): Deque() { _copy_from(d); }
+    // move (the allocator follows the buffer it allocated)
+    Deque(Deque&& d): _data{d._data}, _capacity{d._capacity}, _head{d._head}, _size{d._size}, _alloc{std::move(d._alloc)} {
+        d._data = NULL;
+        d._capacity = d._head = d._size = 0;
+    }
+
+    ~Deque() {
+        clear();
+        _alloc.deallocate(_data, _capacity);
+        _data = NULL;
+        _capacity = 0;
+    }
+
+    // copy assign
+    Deque& operator=(const Deque& d) {
+        if(&d != this) {
+            clear();
+            _copy_from(d);
+        }
+        return *this;
+    }
+    // move assign
+    Deque& operator=(Deque&& d) {
+        if(&d != this) {
+            clear();
+            _alloc.deallocate(_data, _capacity);
+            _alloc = std::move(d._alloc);
+            _data = d._data;
+            _capacity = d._capacity;
+            _head = d._head;
+            _size = d._size;
+            d._data = NULL;
+            d._capacity = d._head = d._size = 0;
+        }
+        return *this;
+    }
+
+    // iterator
+    Iterator begin() { return Iterator(_data, _mask(), _head); }
+    ConstIterator begin() const { return ConstIterator(_data, _mask(), _head); }
+    Iterator end() { return Iterator(_data, _mask(), _head + _size); }
+    ConstIterator end() const { return ConstIterator(_data, _mask(), _head + _size); }
+
+    // size
+    size_t size() const { return _size; }
+    size_t capacity() const { return _capacity; }
+    bool empty() const { return _size == 0; }
+
+    // access
+    T& operator[](const size_t& index) {
+        if(index >= _size) throw std::out_of_range("deque index out of range");
+        return *_slot(index);
+    }
+    const T& operator[](const size_t& index) const {
+        if(index >= _size) throw std::out_of_range("deque index out of range");
+        return *_slot(index);
+    }
+    T& at_unchecked(const size_t& index) { return *_slot(index); }
+    const T& at_unchecked(const size_t& index) const { return *_slot(index); }
+    // use operator[] to enforce range check
+    T& front() { return operator[](0); }
+    T& back() { return operator[](_size - 1); }
+
+    // modify
+    void push_back(const T& item) {
+        if(_size == _capacity) {
+            // item may live in this deque
+            T tmp(item);
+            _reserve(_size + 1);
+            _alloc.construct(_slot(_size), std::move(tmp));
+        }
+        else _alloc.construct(_slot(_size), item);
+        ++_size;
+    }
+    void push_back(T&& item) {
+        _reserve(_size + 1);
+        _alloc.construct(_slot(_size), std::move(item));
+        ++_size;
+    }
+    void push_front(const T& item) {
+        if(_size == _capacity) {
+            T tmp(item);
+            _reserve(_size + 1);
+            _head = (_head - 1) & _mask();
+            _alloc.construct(_data + _head, std::move(tmp));
+        } else {
+            _head = (_head - 1) & _mask();
+            _alloc.construct(_data + _head, item);
+        }
+        ++_size;
+    }
+    void push_front(T&& item) {
+        _reserve(_size + 1);
+        _head = (_head - 1) & _mask();
+        _alloc.construct(_data + _head, std::move(item));
+        ++_size;
+    }
+    void pop_back() {
+        if(_size == 0) throw std::underflow_error("deque pop_back underflow");
+        _alloc.destroy(_slot(--_size));
+    }
+    void pop_front() {
+        if(_size == 0) throw std::underflow_error("deque pop_front underflow");
+        _alloc.destroy(_data + _head);
+        _head = (_head + 1) & _mask();
+        --_size;
+    }
+
+    // bulk: copy n items to the back, at most two block copies
+    void push_back_n(const T* items, const size_t& n) {
+        _reserve(_size + n);
+        size_t tail = (_head + _size) & _mask(), first = Min(n, _capacity - tail);
+        UninitializedCopy(items, items + first, _data + tail, _alloc);
+        UninitializedCopy(items + first, items + n, _data, _alloc);
+        _size += n;
+    }
+    // bulk: move the first n items out to out (raw memory, e.g. a reserved buffer), then drop them
+    void pop_front_n(T* out, const size_t& n) {
+        if(n > _size) throw std::underflow_error("deque pop_front_n underflow");
+        size_t first = Min(n, _capacity - _head);
+        Relocate(_data + _head, first, out, _alloc);
+        Relocate(_data, n - first, out + first, _alloc);
+        _head = (_head + n) & _mask();
+        _size -= n;
+    }
+    // bulk: drop the first n items
+    void pop_front_n(const size_t& n) {
+        if(n > _size) throw std::underflow_error("deque pop_front_n underflow");
+        size_t first = Min(n, _capacity - _head);
+        DestroyN(_data + _head, first, _alloc);
+        DestroyN(_data, n - first, _alloc);
+        _head = (_head + n) & _mask();
+        _size -= n;
+    }
+
+    // keeps the buffer
+    void clear() { pop_front_n(_size); _head = 0; }
+};
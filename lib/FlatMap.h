@@ -0,0 +1,253 @@
+// flat associative containers: sorted keys in a Vector, searched without branches
+// built once and queried many times, inserts are O(n)
+
+#pragma once
+
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+
+#include "Algorithm.h"
+#include "Vector.h"
+
+#if defined(__GNUC__)
+#define FLAT_PREFETCH(p) __builtin_prefetch(p)
+#else
+#define FLAT_PREFETCH(p)
+#endif
+
+
+// sorted unique keys and the search shared by FlatSet and FlatMap
+template <class K, class Compare, class _Alloc>
+class _FlatBase {
+public:
+    typedef typename Vector<K, _Alloc>::ConstIterator ConstIterator;
+
+    // returned by index lookups when the key is absent
+    static const size_t npos = (size_t)-1;
+
+    // queries searched side by side in lookup_many
+    static const size_t BATCH = 8;
+
+protected:
+    Vector<K, _Alloc> _keys;
+    Compare _comp;
+
+    _FlatBase() { }
+    _FlatBase(Vector<K, _Alloc>&& keys): _keys{std::move(keys)} { }
+
+    // first position whose key is not less than k
+    // the loop only narrows a base pointer, so the comparison compiles to a cmov
+    size_t _lower_bound(const K& k) const {
+        size_t n = _keys.size();
+        if(n == 0) return 0;
+        const K *base = _keys.data();
+        while(n > 1) {
+            size_t half = n / 2;
+            base = _comp(base[half - 1], k) ? base + half : base;
+            n -= half;
+        }
+        return (base - _keys.data()) + (_comp(*base, k) ? 1 : 0);
+    }
+    bool _match(const size_t& i, const K& k) const { return i < _keys.size() && !_comp(k, _keys.data()[i]); }
+
+    // search up to BATCH keys in lock step, every round prefetches the next probe of
+    // each query so their cache misses overlap instead of queueing
+    void _lower_bound_batch(const K* queries, const size_t& m, size_t* out) const {
+        const K *data = _keys.data(), *base[BATCH];
+        for(size_t j = 0; j < m; ++j) base[j] = data;
+        size_t n = _keys.size();
+        if(n == 0) {
+            for(size_t j = 0; j < m; ++j) out[j] = 0;
+            return;
+        }
+        while(n > 1) {
+            size_t half = n / 2;
+            n -= half;
+            for(size_t j = 0; j < m; ++j) {
+                base[j] = _comp(base[j][half - 1], queries[j]) ? base[j] + half : base[j];
+                FLAT_PREFETCH(base[j] + n / 2);
+            }
+        }
+        for(size_t j = 0; j < m; ++j) out[j] = (base[j] - data) + (_comp(*base[j], queries[j]) ? 1 : 0);
+    }
+
+    // sort and drop duplicates in one pass (sorted, so equal keys are neighbours)
+    static size_t _unique(K* keys, const size_t& n, const Compare& comp) {
+        size_t w = 0;
+        for(size_t r = 0; r < n; ++r) {
+            if(w == 0 || comp(keys[w - 1], keys[r])) {
+                if(w != r) keys[w] = std::move(keys[r]);
+                ++w;
+            }
+        }
+        return w;
+    }
+
+public:
+    size_t size() const { return _keys.size(); }
+    bool empty() const { return _keys.empty(); }
+
+    ConstIterator begin() const { return _keys.begin(); }
+    ConstIterator end() const { return _keys.end(); }
+
+    // sorted keys
+    const Vector<K, _Alloc>& keys() const { return _keys; }
+
+    bool contains(const K& k) const { return _match(_lower_bound(k), k); }
+    // position of k among the sorted keys, or npos
+    size_t index_of(const K& k) const {
+        size_t i = _lower_bound(k);
+        return _match(i, k) ? i : npos;
+    }
+
+    // out[i] = index_of(queries[i]), batched
+    void lookup_many(const K* queries, const size_t& n, size_t* out) const {
+        for(size_t i = 0; i < n; i += BATCH) {
+            size_t m = Min(BATCH, n - i);
+            _lower_bound_batch(queries + i, m, out + i);
+            for(size_t j = 0; j < m; ++j) out[i + j] = _match(out[i + j], queries[i + j]) ? out[i + j] : npos;
+        }
+    }
+};
+
+template <class K, class Compare, class _Alloc>
+const size_t _FlatBase<K, Compare, _Alloc>::npos;
+
+template <class K, class Compare, class _Alloc>
+const size_t _FlatBase<K, Compare, _Alloc>::BATCH;
+
+
+template <class K, class Compare = Less, class _Alloc = _Allocator<K>>
+class FlatSet : public _FlatBase<K, Compare, _Alloc> {
+    typedef _FlatBase<K, Compare, _Alloc> _Base;
+
+public:
+    // default
+    FlatSet() { }
+    // bulk: takes the keys over, sorts and dedups them in place
+    explicit FlatSet(Vector<K, _Alloc>&& keys): _Base(std::move(keys)) {
+        K *p = this->_keys.data();
+        Sort(p, p + this->_keys.size(), this->_comp);
+        size_t n = _Base::_unique(p, this->_keys.size(), this->_comp);
+        if(n != this->_keys.size()) this->_keys.resize(n);
+    }
+    explicit FlatSet(const Vector<K, _Alloc>& keys): FlatSet(Vector<K, _Alloc>(keys)) { }
+    FlatSet(std::initializer_list<K> l): FlatSet(Vector<K, _Alloc>(l)) { }
+
+    // O(n), returns false if k was present
+    bool insert(const K& k) {
+        size_t i = this->_lower_bound(k);
+        if(this->_match(i, k)) return false;
+        this->_keys.push_back(k);
+        // bubble the new key down to its place
+        K *p = this->_keys.data();
+        for(size_t j = this->_keys.size() - 1; j > i; --j) Swap(p[j], p[j - 1]);
+        return true;
+    }
+
+    using _Base::lookup_many;
+    // found[i] = contains(queries[i]), batched
+    void lookup_many(const Vector<K, _Alloc>& queries, Vector<bool>& found) const {
+        size_t idx[_Base::BATCH];
+        found = Vector<bool>(queries.size(), false);
+        for(size_t i = 0; i < queries.size(); i += _Base::BATCH) {
+            size_t m = Min(_Base::BATCH, queries.size() - i);
+            _Base::lookup_many(queries.data() + i, m, idx);
+            for(size_t j = 0; j < m; ++j) found.at_unchecked(i + j) = idx[j] != _Base::npos;
+        }
+    }
+};
+
+
+template <class K, class V, class Compare = Less, class _Alloc = _Allocator<K>>
+class FlatMap : public _FlatBase<K, Compare, _Alloc> {
+    typedef _FlatBase<K, Compare, _Alloc> _Base;
+
+public:
+    typedef Vector<V, typename _Alloc::template rebind<V>> ValueVector;
+
+protected:
+    // values[i] belongs to keys[i], kept apart so searches only touch keys
+    ValueVector _values;
+
+public:
+    // default
+    FlatMap() { }
+    // bulk: keys[i] maps to values[i], the first of equal keys wins
+    FlatMap(Vector<K, _Alloc>&& keys, ValueVector&& values) {
+        size_t n = keys.size();
+        if(n != values.size()) throw std::invalid_argument("flat map keys and values differ in size");
+        // sort a permutation, ties broken by position so the first duplicate comes first
+        Vector<size_t> perm(n, 0);
+        for(size_t i = 0; i < n; ++i) perm.at_unchecked(i) = i;
+        const K *k = keys.data();
+        const Compare& comp = this->_comp;
+        Sort(perm.data(), perm.data() + n, [k, &comp](const size_t& a, const size_t& b) {
+            return comp(k[a], k[b]) || (!comp(k[b], k[a]) && a < b);
+        });
+        for(size_t i = 0; i < n; ++i) {
+            size_t j = perm.at_unchecked(i);
+            if(this->_keys.empty() || comp(this->_keys.back(), keys.at_unchecked(j))) {
+                this->_keys.push_back(std::move(keys.at_unchecked(j)));
+                _values.push_back(std::move(values.at_unchecked(j)));
+            }
+        }
+    }
+    FlatMap(std::initializer_list<std::pair<K, V>> l) {
+        Vector<K, _Alloc> keys;
+        ValueVector values;
+        for(auto it = l.begin(); it != l.end(); ++it) {
+            keys.push_back(it->first);
+            values.push_back(it->second);
+        }
+        *this = FlatMap(std::move(keys), std::move(values));
+    }
+
+    // sorted values (same order as keys())
+    const ValueVector& values() const { return _values; }
+
+    // NULL if absent
+    const V* find(const K& k) const {
+        size_t i = this->index_of(k);
+        return i == _Base::npos ? NULL : _values.data() + i;
+    }
+    V* find(const K& k) {
+        size_t i = this->index_of(k);
+        return i == _Base::npos ? NULL : _values.data() + i;
+    }
+    const V& at(const K& k) const {
+        const V *v = find(k);
+        if(v == NULL) throw std::out_of_range("flat map key not found");
+        return *v;
+    }
+
+    // O(n), returns false (and keeps the old value) if k was present
+    bool insert(const K& k, const V& v) {
+        size_t i = this->_lower_bound(k);
+        if(this->_match(i, k)) return false;
+        this->_keys.push_back(k);
+        _values.push_back(v);
+        K *pk = this->_keys.data();
+        V *pv = _values.data();
+        for(size_t j = this->_keys.size() - 1; j > i; --j) {
+            Swap(pk[j], pk[j - 1]);
+            Swap(pv[j], pv[j - 1]);
+        }
+        return true;
+    }
+
+    using _Base::lookup_many;
+    // out[i] = find(queries[i]), batched
+    void lookup_many(const Vector<K, _Alloc>& queries, Vector<const V*>& out) const {
+        size_t idx[_Base::BATCH];
+        out = Vector<const V*>(queries.size(), NULL);
+        for(size_t i = 0; i < queries.size(); i += _Base::BATCH) {
+            size_t m = Min(_Base::BATCH, queries.size() - i);
+            _Base::lookup_many(queries.data() + i, m, idx);
+            for(size_t j = 0; j < m; ++j) {
+                if(idx[j] != _Base::npos) out.at_unchecked(i + j) = _values.data() + idx[j];
+            }
+        }
+    }
+};
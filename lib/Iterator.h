@@ -1,43 +1,54 @@
-// basic iterator 
-// https://sourceforge.net/project/showfiles.php?group_id=146814 
+// basic iterator
+// https://sourceforge.net/project/showfiles.php?group_id=146814
 
 #pragma once
 
 #include <cstddef>
+#include <iterator>
+#include <type_traits>
 
 
 // basic iterator
-template <class T, class DifferenceType = const ptrdiff_t&>
+// carries the std iterator traits, so std algorithms and our own dispatch can see its category
+template <class T, class DifferenceType = std::ptrdiff_t>
 class _Iterator {
+public:
+    typedef std::bidirectional_iterator_tag iterator_category;
+    typedef std::remove_cv_t<T> value_type;
+    typedef DifferenceType difference_type;
+    typedef T* pointer;
+    typedef T& reference;
+
 protected: // in case of inheritance
     T *_cur;
 
 public:
-    _Iterator(T* cur = NULL): _cur{cur} { }
-    _Iterator(const _Iterator& it): _cur{it._cur} { }
+    constexpr _Iterator(T* cur = NULL): _cur{cur} { }
+    constexpr _Iterator(const _Iterator& it): _cur{it._cur} { }
 
-    _Iterator& operator=(const _Iterator& it) {
+    constexpr _Iterator& operator=(const _Iterator& it) {
         _cur = it._cur;
         return *this;
     }
 
-    T* base() const { return _cur; }
-    T& operator*() { return *_cur; }
+    constexpr T* base() const { return _cur; }
+    constexpr T& operator*() const { return *_cur; }
+    constexpr T* operator->() const { return _cur; }
 
-    _Iterator& operator++() {
+    constexpr _Iterator& operator++() {
         ++_cur;
         return *this;
     }
-    _Iterator operator++(int) {
+    constexpr _Iterator operator++(int) {
         _Iterator it(*this);
         ++_cur;
         return it;
     }
-    _Iterator& operator--() {
+    constexpr _Iterator& operator--() {
         --_cur;
         return *this;
     }
-    _Iterator operator--(int) {
+    constexpr _Iterator operator--(int) {
         _Iterator ret(*this);
         --_cur;
         return ret;
@@ -49,28 +60,29 @@ public:
 template <class T, class D> class _RandomIterator;
 
 
-template <class T, class DifferenceType = const ptrdiff_t&>
+template <class T, class DifferenceType = std::ptrdiff_t>
 class _ReverseIterator: public _Iterator<T, DifferenceType> {
 public:
-    _ReverseIterator(const _Iterator<T, DifferenceType>& it): _Iterator<T, DifferenceType>(it) { }
+    constexpr _ReverseIterator(const _Iterator<T, DifferenceType>& it): _Iterator<T, DifferenceType>(it) { }
 
-    T* base() const { return this->_cur; }
-    T& operator*() { return *(this->_cur - 1); }
+    constexpr T* base() const { return this->_cur; }
+    constexpr T& operator*() const { return *(this->_cur - 1); }
+    constexpr T* operator->() const { return this->_cur - 1; }
 
-    _ReverseIterator& operator++() {
+    constexpr _ReverseIterator& operator++() {
         --this->_cur;
         return *this;
     }
-    _ReverseIterator operator++(int) {
+    constexpr _ReverseIterator operator++(int) {
         _ReverseIterator it(*this);
         --this->_cur;
         return it;
     }
-    _ReverseIterator& operator--() {
+    constexpr _ReverseIterator& operator--() {
         ++this->_cur;
         return *this;
     }
-    _ReverseIterator operator--(int) {
+    constexpr _ReverseIterator operator--(int) {
         _ReverseIterator ret(*this);
         ++this->_cur;
         return ret;
@@ -79,61 +91,172 @@ public:
 
 
 // random access iterator, memory must be continuous by default
-template <class T, class DifferenceType = const std::ptrdiff_t&>
+// increments are redeclared so they return the derived type, as std algorithms expect
+template <class T, class DifferenceType = std::ptrdiff_t>
 class _RandomIterator : public _Iterator<T, DifferenceType> {
 public:
-    _RandomIterator(const _Iterator<T, DifferenceType>& it): _Iterator<T, DifferenceType>(it) { }
+    typedef std::random_access_iterator_tag iterator_category;
+#if __cplusplus >= 202002L
+    typedef std::contiguous_iterator_tag iterator_concept;
+#endif
+    // elements are adjacent in memory, ranges can be copied as one block
+    typedef std::true_type is_contiguous;
+
+    constexpr _RandomIterator(const _Iterator<T, DifferenceType>& it = _Iterator<T, DifferenceType>()): _Iterator<T, DifferenceType>(it) { }
+    constexpr _RandomIterator(T* cur): _Iterator<T, DifferenceType>(cur) { }
+    // Iterator converts to ConstIterator
+    template <class U, class = std::enable_if_t<!std::is_same<U, T>::value && std::is_convertible<U*, T*>::value>>
+    constexpr _RandomIterator(const _RandomIterator<U, DifferenceType>& it): _Iterator<T, DifferenceType>(it.base()) { }
+
+    constexpr _RandomIterator& operator++() {
+        ++this->_cur;
+        return *this;
+    }
+    constexpr _RandomIterator operator++(int) {
+        _RandomIterator it(*this);
+        ++this->_cur;
+        return it;
+    }
+    constexpr _RandomIterator& operator--() {
+        --this->_cur;
+        return *this;
+    }
+    constexpr _RandomIterator operator--(int) {
+        _RandomIterator ret(*this);
+        --this->_cur;
+        return ret;
+    }
 
     // must specify this->_cur (compiler doesn't know the dependence)
-    _RandomIterator operator+(const DifferenceType diff) { return _RandomIterator(this->_cur + diff); }
-    _RandomIterator& operator+=(const DifferenceType diff) {
+    constexpr _RandomIterator operator+(const DifferenceType diff) const { return _RandomIterator(this->_cur + diff); }
+    constexpr _RandomIterator& operator+=(const DifferenceType diff) {
         this->_cur += diff;
         return *this;
     }
-    _RandomIterator operator-(const DifferenceType diff) { return _RandomIterator(this->_cur - diff); }
-    _RandomIterator& operator-=(const DifferenceType diff) {
+    constexpr _RandomIterator operator-(const DifferenceType diff) const { return _RandomIterator(this->_cur - diff); }
+    constexpr _RandomIterator& operator-=(const DifferenceType diff) {
         this->_cur -= diff;
         return *this;
     }
 
-    T& operator[](DifferenceType diff) { return *(this->_cur + diff); }
+    constexpr T& operator[](const DifferenceType diff) const { return *(this->_cur + diff); }
 };
 
 
-template <class T, class DifferenceType = const std::ptrdiff_t&>
+template <class T, class DifferenceType = std::ptrdiff_t>
 class _RandomReverseIterator : public _ReverseIterator<T, DifferenceType> {
 public:
+    typedef std::random_access_iterator_tag iterator_category;
+
     using _ReverseIterator<T, DifferenceType>::_ReverseIterator;
     // can only list initialize direct base class
-    _RandomReverseIterator(const _Iterator<T, DifferenceType>& it): _ReverseIterator<T, DifferenceType>(it) { }
+    constexpr _RandomReverseIterator(const _Iterator<T, DifferenceType>& it = _Iterator<T, DifferenceType>()): _ReverseIterator<T, DifferenceType>(it) { }
+    template <class U, class = std::enable_if_t<!std::is_same<U, T>::value && std::is_convertible<U*, T*>::value>>
+    constexpr _RandomReverseIterator(const _RandomReverseIterator<U, DifferenceType>& it):
+        _ReverseIterator<T, DifferenceType>(_Iterator<T, DifferenceType>(it.base())) { }
+
+    constexpr _RandomReverseIterator& operator++() {
+        --this->_cur;
+        return *this;
+    }
+    constexpr _RandomReverseIterator operator++(int) {
+        _RandomReverseIterator it(*this);
+        --this->_cur;
+        return it;
+    }
+    constexpr _RandomReverseIterator& operator--() {
+        ++this->_cur;
+        return *this;
+    }
+    constexpr _RandomReverseIterator operator--(int) {
+        _RandomReverseIterator ret(*this);
+        ++this->_cur;
+        return ret;
+    }
 
     // must specify this->_cur (compiler doesn't know the dependence)
-    _RandomReverseIterator operator+(const DifferenceType diff) { return _RandomReverseIterator(this->_cur - diff); }
-    _RandomReverseIterator& operator+=(const DifferenceType diff) {
+    constexpr _RandomReverseIterator operator+(const DifferenceType diff) const { return _RandomReverseIterator(this->_cur - diff); }
+    constexpr _RandomReverseIterator& operator+=(const DifferenceType diff) {
         this->_cur -= diff;
         return *this;
     }
-    _RandomReverseIterator operator-(const DifferenceType diff) { return _RandomReverseIterator(this->_cur + diff); }
-    _RandomReverseIterator& operator-=(const DifferenceType diff) {
+    constexpr _RandomReverseIterator operator-(const DifferenceType diff) const { return _RandomReverseIterator(this->_cur + diff); }
+    constexpr _RandomReverseIterator& operator-=(const DifferenceType diff) {
         this->_cur += diff;
         return *this;
     }
 
-    T& operator[](DifferenceType diff) { return *(this->_cur - diff); }
+    constexpr T& operator[](const DifferenceType diff) const { return *(this->_cur - diff - 1); }
 };
 
 
 template <class T, class D>
-bool operator==(const _Iterator<T, D>& lhs, const _Iterator<T, D>& rhs) { return lhs.base() == rhs.base(); }
+constexpr bool operator==(const _Iterator<T, D>& lhs, const _Iterator<T, D>& rhs) { return lhs.base() == rhs.base(); }
+
+template <class T, class D>
+constexpr bool operator!=(const _Iterator<T, D>& lhs, const _Iterator<T, D>& rhs) { return lhs.base() != rhs.base(); }
+
+template <class T, class D>
+constexpr bool operator<(const _Iterator<T, D>& lhs, const _Iterator<T, D>& rhs) { return lhs.base() < rhs.base(); }
+
+template <class T, class D>
+constexpr bool operator>(const _Iterator<T, D>& lhs, const _Iterator<T, D>& rhs) { return rhs < lhs; }
 
 template <class T, class D>
-bool operator!=(const _Iterator<T, D>& lhs, const _Iterator<T, D>& rhs) { return lhs.base() != rhs.base(); }
+constexpr bool operator<=(const _Iterator<T, D>& lhs, const _Iterator<T, D>& rhs) { return !(rhs < lhs); }
 
 template <class T, class D>
-bool operator<(const _Iterator<T, D>& lhs, const _Iterator<T, D>& rhs) { return lhs.base() < rhs.base(); }
+constexpr bool operator>=(const _Iterator<T, D>& lhs, const _Iterator<T, D>& rhs) { return !(lhs < rhs); }
 
+// reverse iterators order the other way round
 template <class T, class D>
-ptrdiff_t operator-(const _RandomIterator<T, D>& lhs, const _RandomIterator<T, D>& rhs) { return lhs.base() - rhs.base(); }
+constexpr bool operator<(const _ReverseIterator<T, D>& lhs, const _ReverseIterator<T, D>& rhs) { return rhs.base() < lhs.base(); }
 
 template <class T, class D>
-ptrdiff_t operator-(const _RandomReverseIterator<T, D>& lhs, const _RandomReverseIterator<T, D>& rhs) { return rhs.base() - lhs.base(); }
+constexpr bool operator>(const _ReverseIterator<T, D>& lhs, const _ReverseIterator<T, D>& rhs) { return rhs < lhs; }
+
+template <class T, class D>
+constexpr bool operator<=(const _ReverseIterator<T, D>& lhs, const _ReverseIterator<T, D>& rhs) { return !(rhs < lhs); }
+
+template <class T, class D>
+constexpr bool operator>=(const _ReverseIterator<T, D>& lhs, const _ReverseIterator<T, D>& rhs) { return !(lhs < rhs); }
+
+template <class T, class D>
+constexpr D operator-(const _RandomIterator<T, D>& lhs, const _RandomIterator<T, D>& rhs) { return lhs.base() - rhs.base(); }
+
+template <class T, class D>
+constexpr D operator-(const _RandomReverseIterator<T, D>& lhs, const _RandomReverseIterator<T, D>& rhs) { return rhs.base() - lhs.base(); }
+
+template <class T, class D>
+constexpr _RandomIterator<T, D> operator+(const typename _RandomIterator<T, D>::difference_type diff, const _RandomIterator<T, D>& it) { return it + diff; }
+
+template <class T, class D>
+constexpr _RandomReverseIterator<T, D> operator+(const typename _RandomReverseIterator<T, D>::difference_type diff, const _RandomReverseIterator<T, D>& it) { return it + diff; }
+
+
+// compile-time iterator properties, used to pick bulk memory paths
+
+// has std iterator traits (our iterators, pointers, std iterators)
+template <class Iter, class = void>
+struct _IsIterator : std::false_type { };
+
+template <class Iter>
+struct _IsIterator<Iter, std::void_t<typename std::iterator_traits<Iter>::iterator_category>> : std::true_type { };
+
+// category at least Tag
+template <class Iter, class Tag>
+using _HasCategory = std::is_base_of<Tag, typename std::iterator_traits<Iter>::iterator_category>;
+
+// raw pointers and iterators tagged is_contiguous
+template <class Iter, class = void>
+struct _IsContiguous : std::is_pointer<Iter> { };
+
+template <class Iter>
+struct _IsContiguous<Iter, std::void_t<typename Iter::is_contiguous>> : Iter::is_contiguous { };
+
+// address of the element an iterator refers to
+template <class T>
+constexpr T* _Address(T* p) { return p; }
+
+template <class Iter>
+constexpr auto _Address(const Iter& it) { return it.base(); }
@@ -4,6 +4,7 @@
 
 #include <iostream>
 #include <exception>
+#include <utility>
 
 #include "Allocator.h"
 #include "Iterator.h"
@@ -29,50 +30,66 @@ public:
     typedef _Iterator<const Node> ConstIterator;
 
 protected:
+    // nodes are allocated through the allocator rebound to Node
+    typedef typename _Alloc::template rebind<Node> _NodeAlloc;
+
+    // declared first, it must be ready before the pseudo head is allocated
+    _NodeAlloc _alloc;
     Node *_head;
     size_t _size;
 
+    // Node is not copyable, so construct in place instead of _alloc.construct
+    template <class... Args>
+    Node* _new_node(Args&&... args) {
+        Node *p = _alloc.allocate(1);
+        new((void*)p) Node(std::forward<Args>(args)...);
+        return p;
+    }
+    void _delete_node(Node* p) {
+        _alloc.destroy(p);
+        _alloc.deallocate(p, 1);
+    }
+
 public:
     // default
-    List(): _head{new Node()}, _size{0} { }
+    List(): _head{_new_node()}, _size{0} { }
     // from size
-    List(const size_t& n, const T& value): _head{new Node()}, _size{n} {
+    List(const size_t& n, const T& value): _head{_new_node()}, _size{n} {
         // set a pseudo head
         Node *p = _head;
         for(int i = 0; i < n; ++i) {
-            p->_next = new Node(value, p);
+            p->_next = _new_node(value, p);
             p = p->_next;
         }
         // set head.prev = NULL
-        _head->_next->_prev = NULL;
+        if(_head->_next != NULL) _head->_next->_prev = NULL;
     }
     // from list
-    List(std::initializer_list<T> l): _head{new Node()}, _size{l.size()} {
+    List(std::initializer_list<T> l): _head{_new_node()}, _size{l.size()} {
         Node *p = _head;
         for(auto it = l.begin(); it != l.end(); ++it) {
-            _head->_next = new Node(*it, p);
+            p->_next = _new_node(*it, p);
             p = p->_next;
         }
-        _head->_next->_prev = NULL;
+        if(_head->_next != NULL) _head->_next->_prev = NULL;
     }
     // copy
-    List(const List& l): _head{new Node()}, _size{l._size} {
-        Node *p = _head, *q = l._head;
+    List(const List& l): _head{_new_node()}, _size{l._size} {
+        Node *p = _head, *q = l._head->_next;
         while(q != NULL) {
-            p->_next = new Node(q->_data, p);
+            p->_next = _new_node(q->_data, p);
             p = p->_next;
             q = q->_next;
         }
-        _head->_next->_prev = NULL;
+        if(_head->_next != NULL) _head->_next->_prev = NULL;
     }
 
     ~List() {
-        if(_head != NULL) {
-            while(_head->_next != NULL) {
-                delete _head->_prev;
-                _head = _head->_next;
-            }
-            delete _head;
+        // free the pseudo head and every node after it
+        while(_head != NULL) {
+            Node *next = _head->_next;
+            _delete_node(_head);
+            _head = next;
         }
         _size = 0;
     }
@@ -0,0 +1,78 @@
+// uninitialized memory helpers used by the containers
+// ranges of trivially copyable elements behind contiguous iterators become a single memcpy/memmove,
+// chosen at compile time from the iterator traits
+
+#pragma once
+
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "Iterator.h"
+
+
+// [first, last) can be copied to out byte for byte
+template <class InIter, class T>
+using _IsBitwiseCopyable = std::integral_constant<bool,
+    _IsContiguous<InIter>::value &&
+    std::is_same<typename std::iterator_traits<InIter>::value_type, std::remove_cv_t<T>>::value &&
+    std::is_trivially_copyable<T>::value>;
+
+// number of steps from first to last (constant time for random access)
+template <class Iter>
+constexpr typename std::iterator_traits<Iter>::difference_type Distance(Iter first, const Iter& last) {
+    if constexpr (_HasCategory<Iter, std::random_access_iterator_tag>::value) return last - first;
+    else {
+        typename std::iterator_traits<Iter>::difference_type n = 0;
+        for(; first != last; ++first) ++n;
+        return n;
+    }
+}
+
+// copy construct [first, last) into raw memory at out, returns the end of the constructed range
+template <class InIter, class T, class Alloc>
+T* UninitializedCopy(InIter first, const InIter& last, T* out, Alloc& alloc) {
+    if constexpr (_IsBitwiseCopyable<InIter, T>::value) {
+        size_t n = last - first;
+        if(n > 0) memcpy((void*)out, (const void*)_Address(first), n * sizeof(T));
+        return out + n;
+    } else {
+        for(; first != last; ++first, ++out) alloc.construct(out, *first);
+        return out;
+    }
+}
+
+// n copies of value into raw memory at out
+template <class T, class Alloc>
+T* UninitializedFill(T* out, const size_t& n, const T& value, Alloc& alloc) {
+    for(size_t i = 0; i < n; ++i) alloc.construct(out + i, value);
+    return out + n;
+}
+
+// move n objects from src to raw memory at dst and destroy the sources
+// the ranges may overlap (the elements are walked in a safe order)
+template <class T, class Alloc>
+void Relocate(T* src, const size_t& n, T* dst, Alloc& alloc) {
+    if(n == 0 || src == dst) return;
+    if constexpr (std::is_trivially_copyable<T>::value) memmove((void*)dst, (const void*)src, n * sizeof(T));
+    else if(dst < src) {
+        for(size_t i = 0; i < n; ++i) {
+            alloc.construct(dst + i, std::move(src[i]));
+            alloc.destroy(src + i);
+        }
+    } else {
+        for(size_t i = n; i-- > 0; ) {
+            alloc.construct(dst + i, std::move(src[i]));
+            alloc.destroy(src + i);
+        }
+    }
+}
+
+// destroy n objects (nothing to do for trivial destructors), last first
+template <class T, class Alloc>
+void DestroyN(T* p, const size_t& n, Alloc& alloc) {
+    if constexpr (!std::is_trivially_destructible<T>::value) {
+        for(size_t i = n; i-- > 0; ) alloc.destroy(p + i);
+    }
+}
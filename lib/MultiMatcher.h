@@ -0,0 +1,254 @@
+// multi-pattern literal search: Aho-Corasick automaton compiled to a dense DFA
+// one table lookup per input byte however many patterns there are, every hit reported in a single pass
+// usage:
+//   MultiMatcher m({"ERROR", "WARN", "timeout"});
+//   if(m.contains(line)) ...
+//   m.scan(buf, n, [](const size_t& pattern, const size_t& position) { ... });
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <stdexcept>
+
+#include "String.h"
+#include "Vector.h"
+#include "View.h"
+
+
+// pattern index (in the order given) and offset of its first byte in the text
+struct MultiMatch {
+    size_t pattern;
+    size_t position;
+};
+
+inline bool operator==(const MultiMatch& lhs, const MultiMatch& rhs) {
+    return lhs.pattern == rhs.pattern && lhs.position == rhs.position;
+}
+
+
+class MultiMatcher {
+protected:
+    // flags a transition whose target reports patterns, so the scan loop tests the value it already loaded
+    static constexpr uint32_t _ACCEPT = 0x80000000u;
+    static constexpr uint32_t _NONE = 0xffffffffu;
+
+    // byte -> column, the bytes of no pattern share column 0, so rows are as narrow as the patterns' alphabet
+    uint32_t _class[256];
+    uint32_t _classes;
+    // row offset (state * _classes) of the next state, the root is row 0
+    Vector<uint32_t> _delta;
+    // patterns ending at state s are _ids[_first[s], _first[s + 1]),
+    // then those of _dict[s], the next shorter suffix state that has some (0 when none)
+    Vector<uint32_t> _first;
+    Vector<uint32_t> _ids;
+    Vector<uint32_t> _dict;
+    Vector<size_t> _lengths;
+    // when every pattern starts with the same byte, memchr skips the text between candidates
+    int _start;
+
+    void _build(const Vector<StringView>& patterns) {
+        size_t count = patterns.size(), total = 1;
+        if(count >= _ACCEPT) throw std::overflow_error("multi matcher has too many patterns");
+        memset(_class, 0, sizeof(_class));
+        _classes = 1;
+        _lengths = Vector<size_t>();
+        _lengths.reserve(count);
+        for(size_t i = 0; i < count; ++i) {
+            const StringView& p = patterns.at_unchecked(i);
+            if(p.length() == 0) throw std::invalid_argument("multi matcher pattern is empty");
+            for(size_t j = 0; j < p.length(); ++j) {
+                unsigned char b = p.c_str()[j];
+                if(_class[b] == 0) _class[b] = _classes++;
+            }
+            _lengths.push_back(p.length());
+            total += p.length();
+        }
+
+        // trie, at most one state per pattern byte
+        const size_t C = _classes;
+        Vector<uint32_t> next(total * C, _NONE);
+        Vector<uint32_t> terminal;
+        terminal.reserve(count);
+        size_t states = 1;
+        for(size_t i = 0; i < count; ++i) {
+            const StringView& p = patterns.at_unchecked(i);
+            size_t s = 0;
+            for(size_t j = 0; j < p.length(); ++j) {
+                uint32_t& t = next.at_unchecked(s * C + _class[(unsigned char)p.c_str()[j]]);
+                if(t == _NONE) t = states++;
+                s = t;
+            }
+            terminal.push_back(s);
+        }
+        if(states * C >= _ACCEPT) throw std::overflow_error("multi matcher automaton is too large");
+
+        // renumber breadth first, so the shallow states where a scan spends most of its time share the first rows
+        Vector<uint32_t> rank(states, 0), order;
+        order.reserve(states);
+        order.push_back(0);
+        for(size_t head = 0; head < order.size(); ++head) {
+            const uint32_t *row = next.data() + order.at_unchecked(head) * C;
+            for(size_t c = 0; c < C; ++c) {
+                if(row[c] == _NONE) continue;
+                rank.at_unchecked(row[c]) = order.size();
+                order.push_back(row[c]);
+            }
+        }
+        Vector<uint32_t> table(states * C, _NONE);
+        uint32_t *delta = table.data();
+        for(size_t s = 0; s < states; ++s) {
+            const uint32_t *row = next.data() + order.at_unchecked(s) * C;
+            for(size_t c = 0; c < C; ++c) if(row[c] != _NONE) delta[s * C + c] = rank.at_unchecked(row[c]);
+        }
+        next = Vector<uint32_t>();
+        for(size_t i = 0; i < count; ++i) terminal.at_unchecked(i) = rank.at_unchecked(terminal.at_unchecked(i));
+
+        // own patterns of every state, grouped by a counting pass
+        _first = Vector<uint32_t>(states + 1, 0);
+        for(size_t i = 0; i < count; ++i) ++_first.at_unchecked(terminal.at_unchecked(i) + 1);
+        for(size_t s = 0; s < states; ++s) _first.at_unchecked(s + 1) += _first.at_unchecked(s);
+        _ids = Vector<uint32_t>(count, 0);
+        Vector<uint32_t> fill(_first.data(), _first.data() + states);
+        for(size_t i = 0; i < count; ++i) _ids.at_unchecked(fill.at_unchecked(terminal.at_unchecked(i))++) = i;
+
+        // states are now in breadth first order: a missing edge takes the edge of the failure state,
+        // whose row is already complete (the root's missing edges and its children's failures are the root)
+        Vector<uint32_t> fail(states, 0);
+        for(size_t s = 0; s < states; ++s) {
+            uint32_t *row = delta + s * C;
+            const uint32_t *fail_row = delta + fail.at_unchecked(s) * C;
+            for(size_t c = 0; c < C; ++c) {
+                uint32_t to = s == 0 ? 0 : fail_row[c];
+                if(row[c] == _NONE) row[c] = to;
+                else fail.at_unchecked(row[c]) = to;
+            }
+        }
+        _dict = Vector<uint32_t>(states, 0);
+        for(size_t s = 1; s < states; ++s) {
+            uint32_t f = fail.at_unchecked(s);
+            _dict.at_unchecked(s) = _first.at_unchecked(f) != _first.at_unchecked(f + 1) ? f : _dict.at_unchecked(f);
+        }
+
+        // state numbers to flagged row offsets
+        for(size_t i = 0; i < states * C; ++i) {
+            uint32_t t = delta[i];
+            bool accept = _first.at_unchecked(t) != _first.at_unchecked(t + 1) || _dict.at_unchecked(t) != 0;
+            delta[i] = t * C | (accept ? _ACCEPT : 0);
+        }
+        _delta = std::move(table);
+
+        _start = -1;
+        for(size_t c = 1; c < C; ++c) {
+            if(_delta.at_unchecked(c) == 0) continue;
+            if(_start != -1) {
+                _start = -1;
+                break;
+            }
+            for(int b = 0; b < 256; ++b) if(_class[b] == c) _start = b;
+        }
+    }
+
+    // runs the automaton, on_accept(state, end) is called at every accepting state and stops the scan by returning false
+    template <class OnAccept>
+    void _run(const char* data, const size_t& n, const OnAccept& on_accept) const {
+        const uint32_t *delta = _delta.data();
+        uint32_t s = 0;
+        if(_start < 0) {
+            // the loop carries only the table lookup, hits are the rare branch
+            for(size_t i = 0; i < n; ++i) {
+                s = delta[s + _class[(unsigned char)data[i]]];
+                if(s & _ACCEPT) {
+                    s ^= _ACCEPT;
+                    if(!on_accept(s / _classes, i + 1)) return;
+                }
+            }
+            return;
+        }
+        for(size_t i = 0; i < n; ++i) {
+            if(s == 0) {
+                const char *p = (const char*)memchr(data + i, _start, n - i);
+                if(p == NULL) return;
+                i = p - data;
+            }
+            s = delta[s + _class[(unsigned char)data[i]]];
+            if(s & _ACCEPT) {
+                s ^= _ACCEPT;
+                if(!on_accept(s / _classes, i + 1)) return;
+            }
+        }
+    }
+
+    // every pattern ending at state, longest first
+    template <class F>
+    void _report(uint32_t state, const size_t& end, F& f) const {
+        for(; state != 0; state = _dict.at_unchecked(state)) {
+            for(uint32_t k = _first.at_unchecked(state); k < _first.at_unchecked(state + 1); ++k) {
+                uint32_t id = _ids.at_unchecked(k);
+                f((size_t)id, end - _lengths.at_unchecked(id));
+            }
+        }
+    }
+
+public:
+    // patterns are raw bytes (case sensitive, no regex syntax), duplicates are reported once per index
+    MultiMatcher(std::initializer_list<const char*> patterns) {
+        Vector<StringView> views;
+        views.reserve(patterns.size());
+        for(const char* p : patterns) views.push_back(StringView(p, strlen(p)));
+        _build(views);
+    }
+    explicit MultiMatcher(const Vector<String>& patterns) {
+        Vector<StringView> views;
+        views.reserve(patterns.size());
+        for(size_t i = 0; i < patterns.size(); ++i) {
+            const String& p = patterns.at_unchecked(i);
+            views.push_back(StringView(p.c_str(), p.length()));
+        }
+        _build(views);
+    }
+    explicit MultiMatcher(const Vector<StringView>& patterns) { _build(patterns); }
+
+    // number of patterns
+    size_t size() const { return _lengths.size(); }
+    // automaton size, states * columns
+    size_t table_size() const { return _delta.size(); }
+
+    // f(pattern, position) for every occurrence, overlapping ones included,
+    // in order of their end, and longest first among those ending at the same byte
+    template <class F>
+    void scan(const char* data, const size_t& n, F&& f) const {
+        _run(data, n, [this, &f](const uint32_t& state, const size_t& end) {
+            _report(state, end, f);
+            return true;
+        });
+    }
+    template <class Alloc, class F>
+    void scan(const _String<char, Alloc>& s, F&& f) const { scan(s.c_str(), s.length(), f); }
+    template <class F>
+    void scan(const StringView& s, F&& f) const { scan(s.c_str(), s.length(), f); }
+
+    // all occurrences, in scan order
+    Vector<MultiMatch> find_all(const char* data, const size_t& n) const {
+        Vector<MultiMatch> ret;
+        scan(data, n, [&ret](const size_t& pattern, const size_t& position) { ret.push_back(MultiMatch{pattern, position}); });
+        return ret;
+    }
+    template <class Alloc>
+    Vector<MultiMatch> find_all(const _String<char, Alloc>& s) const { return find_all(s.c_str(), s.length()); }
+    Vector<MultiMatch> find_all(const StringView& s) const { return find_all(s.c_str(), s.length()); }
+
+    // whether any pattern occurs, stops at the first hit
+    bool contains(const char* data, const size_t& n) const {
+        bool found = false;
+        _run(data, n, [&found](const uint32_t&, const size_t&) {
+            found = true;
+            return false;
+        });
+        return found;
+    }
+    template <class Alloc>
+    bool contains(const _String<char, Alloc>& s) const { return contains(s.c_str(), s.length()); }
+    bool contains(const StringView& s) const { return contains(s.c_str(), s.length()); }
+};
@@ -0,0 +1,325 @@
+// numeric kernels over Vector of arithmetic types
+// float and double run explicit AVX2 or SSE2 kernels picked at runtime (x86 with gcc/clang),
+// everything else runs unchecked scalar loops over data() that the compiler can vectorize
+
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+#include "Vector.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && defined(__SSE2__)
+#define NUMERIC_X86_SIMD
+#include <immintrin.h>
+#endif
+
+
+// enable only for arithmetic element types
+template <class T, class R = void>
+using _EnableArithmetic = std::enable_if_t<std::is_arithmetic<T>::value, R>;
+
+
+// scalar kernels (any arithmetic type)
+// independent accumulators break the add dependency chain
+
+template <class T>
+inline T _sum_scalar(const T* x, const size_t& n) {
+    T s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    size_t i = 0;
+    for(; i + 4 <= n; i += 4) {
+        s0 += x[i];
+        s1 += x[i + 1];
+        s2 += x[i + 2];
+        s3 += x[i + 3];
+    }
+    for(; i < n; ++i) s0 += x[i];
+    return (s0 + s1) + (s2 + s3);
+}
+
+template <class T>
+inline T _dot_scalar(const T* x, const T* y, const size_t& n) {
+    T s0 = 0, s1 = 0;
+    size_t i = 0;
+    for(; i + 2 <= n; i += 2) {
+        s0 += x[i] * y[i];
+        s1 += x[i + 1] * y[i + 1];
+    }
+    for(; i < n; ++i) s0 += x[i] * y[i];
+    return s0 + s1;
+}
+
+// n must be positive
+template <class T>
+inline T _min_scalar(const T* x, const size_t& n) {
+    T m = x[0];
+    for(size_t i = 1; i < n; ++i) m = x[i] < m ? x[i] : m;
+    return m;
+}
+
+template <class T>
+inline T _max_scalar(const T* x, const size_t& n) {
+    T m = x[0];
+    for(size_t i = 1; i < n; ++i) m = m < x[i] ? x[i] : m;
+    return m;
+}
+
+template <class T>
+inline void _axpy_scalar(T* y, const T& a, const T* x, const size_t& n) {
+    for(size_t i = 0; i < n; ++i) y[i] += a * x[i];
+}
+
+template <class T>
+inline void _add_scalar(T* y, const T* x, const size_t& n) {
+    for(size_t i = 0; i < n; ++i) y[i] += x[i];
+}
+
+template <class T>
+inline void _mul_scalar(T* y, const T* x, const size_t& n) {
+    for(size_t i = 0; i < n; ++i) y[i] *= x[i];
+}
+
+
+#ifdef NUMERIC_X86_SIMD
+
+// lane traits: one register type and the handful of operations the kernels need
+
+#define NUMERIC_AVX2 __attribute__((target("avx2")))
+
+struct _Sse2Float {
+    typedef float T;
+    typedef __m128 V;
+    enum { W = 4 };
+    static V load(const T* p) { return _mm_loadu_ps(p); }
+    static void store(T* p, V v) { _mm_storeu_ps(p, v); }
+    static V set1(T a) { return _mm_set1_ps(a); }
+    static V add(V a, V b) { return _mm_add_ps(a, b); }
+    static V mul(V a, V b) { return _mm_mul_ps(a, b); }
+    static V min(V a, V b) { return _mm_min_ps(a, b); }
+    static V max(V a, V b) { return _mm_max_ps(a, b); }
+};
+
+struct _Sse2Double {
+    typedef double T;
+    typedef __m128d V;
+    enum { W = 2 };
+    static V load(const T* p) { return _mm_loadu_pd(p); }
+    static void store(T* p, V v) { _mm_storeu_pd(p, v); }
+    static V set1(T a) { return _mm_set1_pd(a); }
+    static V add(V a, V b) { return _mm_add_pd(a, b); }
+    static V mul(V a, V b) { return _mm_mul_pd(a, b); }
+    static V min(V a, V b) { return _mm_min_pd(a, b); }
+    static V max(V a, V b) { return _mm_max_pd(a, b); }
+};
+
+struct _Avx2Float {
+    typedef float T;
+    typedef __m256 V;
+    enum { W = 8 };
+    NUMERIC_AVX2 static V load(const T* p) { return _mm256_loadu_ps(p); }
+    NUMERIC_AVX2 static void store(T* p, V v) { _mm256_storeu_ps(p, v); }
+    NUMERIC_AVX2 static V set1(T a) { return _mm256_set1_ps(a); }
+    NUMERIC_AVX2 static V add(V a, V b) { return _mm256_add_ps(a, b); }
+    NUMERIC_AVX2 static V mul(V a, V b) { return _mm256_mul_ps(a, b); }
+    NUMERIC_AVX2 static V min(V a, V b) { return _mm256_min_ps(a, b); }
+    NUMERIC_AVX2 static V max(V a, V b) { return _mm256_max_ps(a, b); }
+};
+
+struct _Avx2Double {
+    typedef double T;
+    typedef __m256d V;
+    enum { W = 4 };
+    NUMERIC_AVX2 static V load(const T* p) { return _mm256_loadu_pd(p); }
+    NUMERIC_AVX2 static void store(T* p, V v) { _mm256_storeu_pd(p, v); }
+    NUMERIC_AVX2 static V set1(T a) { return _mm256_set1_pd(a); }
+    NUMERIC_AVX2 static V add(V a, V b) { return _mm256_add_pd(a, b); }
+    NUMERIC_AVX2 static V mul(V a, V b) { return _mm256_mul_pd(a, b); }
+    NUMERIC_AVX2 static V min(V a, V b) { return _mm256_min_pd(a, b); }
+    NUMERIC_AVX2 static V max(V a, V b) { return _mm256_max_pd(a, b); }
+};
+
+// the kernel bodies are shared, but each copy must be compiled for its own target
+// so they are stamped out once per instruction set
+#define NUMERIC_SIMD_KERNELS(ISA, TARGET) \
+template <class S> \
+TARGET inline typename S::T _sum_##ISA(const typename S::T* x, const size_t& n) { \
+    typename S::V a0 = S::set1(0), a1 = S::set1(0); \
+    size_t i = 0; \
+    for(; i + 2 * S::W <= n; i += 2 * S::W) { \
+        a0 = S::add(a0, S::load(x + i)); \
+        a1 = S::add(a1, S::load(x + i + S::W)); \
+    } \
+    for(; i + S::W <= n; i += S::W) a0 = S::add(a0, S::load(x + i)); \
+    typename S::T lanes[S::W]; \
+    S::store(lanes, S::add(a0, a1)); \
+    return _sum_scalar(lanes, S::W) + _sum_scalar(x + i, n - i); \
+} \
+template <class S> \
+TARGET inline typename S::T _dot_##ISA(const typename S::T* x, const typename S::T* y, const size_t& n) { \
+    typename S::V a0 = S::set1(0), a1 = S::set1(0); \
+    size_t i = 0; \
+    for(; i + 2 * S::W <= n; i += 2 * S::W) { \
+        a0 = S::add(a0, S::mul(S::load(x + i), S::load(y + i))); \
+        a1 = S::add(a1, S::mul(S::load(x + i + S::W), S::load(y + i + S::W))); \
+    } \
+    for(; i + S::W <= n; i += S::W) a0 = S::add(a0, S::mul(S::load(x + i), S::load(y + i))); \
+    typename S::T lanes[S::W]; \
+    S::store(lanes, S::add(a0, a1)); \
+    return _sum_scalar(lanes, S::W) + _dot_scalar(x + i, y + i, n - i); \
+} \
+template <class S> \
+TARGET inline typename S::T _min_##ISA(const typename S::T* x, const size_t& n) { \
+    if(n < S::W) return _min_scalar(x, n); \
+    typename S::V m = S::load(x); \
+    size_t i = S::W; \
+    for(; i + S::W <= n; i += S::W) m = S::min(m, S::load(x + i)); \
+    /* the last (overlapping) block covers the tail */ \
+    m = S::min(m, S::load(x + n - S::W)); \
+    typename S::T lanes[S::W]; \
+    S::store(lanes, m); \
+    return _min_scalar(lanes, S::W); \
+} \
+template <class S> \
+TARGET inline typename S::T _max_##ISA(const typename S::T* x, const size_t& n) { \
+    if(n < S::W) return _max_scalar(x, n); \
+    typename S::V m = S::load(x); \
+    size_t i = S::W; \
+    for(; i + S::W <= n; i += S::W) m = S::max(m, S::load(x + i)); \
+    m = S::max(m, S::load(x + n - S::W)); \
+    typename S::T lanes[S::W]; \
+    S::store(lanes, m); \
+    return _max_scalar(lanes, S::W); \
+} \
+template <class S> \
+TARGET inline void _axpy_##ISA(typename S::T* y, const typename S::T& a, const typename S::T* x, const size_t& n) { \
+    typename S::V va = S::set1(a); \
+    size_t i = 0; \
+    for(; i + S::W <= n; i += S::W) S::store(y + i, S::add(S::load(y + i), S::mul(va, S::load(x + i)))); \
+    _axpy_scalar(y + i, a, x + i, n - i); \
+} \
+template <class S> \
+TARGET inline void _add_##ISA(typename S::T* y, const typename S::T* x, const size_t& n) { \
+    size_t i = 0; \
+    for(; i + S::W <= n; i += S::W) S::store(y + i, S::add(S::load(y + i), S::load(x + i))); \
+    _add_scalar(y + i, x + i, n - i); \
+} \
+template <class S> \
+TARGET inline void _mul_##ISA(typename S::T* y, const typename S::T* x, const size_t& n) { \
+    size_t i = 0; \
+    for(; i + S::W <= n; i += S::W) S::store(y + i, S::mul(S::load(y + i), S::load(x + i))); \
+    _mul_scalar(y + i, x + i, n - i); \
+}
+
+NUMERIC_SIMD_KERNELS(sse2, )
+NUMERIC_SIMD_KERNELS(avx2, NUMERIC_AVX2)
+
+#undef NUMERIC_SIMD_KERNELS
+
+// checked once, the cpu does not change under us
+inline bool _has_avx2() {
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    return avx2;
+}
+
+// dispatch float/double to the widest available kernel (overloads win over the scalar templates)
+#define NUMERIC_DISPATCH(T, SSE, AVX) \
+inline T _sum(const T* x, const size_t& n) { \
+    return _has_avx2() ? _sum_avx2<AVX>(x, n) : _sum_sse2<SSE>(x, n); \
+} \
+inline T _dot(const T* x, const T* y, const size_t& n) { \
+    return _has_avx2() ? _dot_avx2<AVX>(x, y, n) : _dot_sse2<SSE>(x, y, n); \
+} \
+inline T _min(const T* x, const size_t& n) { \
+    return _has_avx2() ? _min_avx2<AVX>(x, n) : _min_sse2<SSE>(x, n); \
+} \
+inline T _max(const T* x, const size_t& n) { \
+    return _has_avx2() ? _max_avx2<AVX>(x, n) : _max_sse2<SSE>(x, n); \
+} \
+inline void _axpy(T* y, const T& a, const T* x, const size_t& n) { \
+    _has_avx2() ? _axpy_avx2<AVX>(y, a, x, n) : _axpy_sse2<SSE>(y, a, x, n); \
+} \
+inline void _add(T* y, const T* x, const size_t& n) { \
+    _has_avx2() ? _add_avx2<AVX>(y, x, n) : _add_sse2<SSE>(y, x, n); \
+} \
+inline void _mul(T* y, const T* x, const size_t& n) { \
+    _has_avx2() ? _mul_avx2<AVX>(y, x, n) : _mul_sse2<SSE>(y, x, n); \
+}
+
+NUMERIC_DISPATCH(float, _Sse2Float, _Avx2Float)
+NUMERIC_DISPATCH(double, _Sse2Double, _Avx2Double)
+
+#undef NUMERIC_DISPATCH
+
+#endif // NUMERIC_X86_SIMD
+
+
+// fallbacks for every other type (and every type off x86)
+template <class T> inline T _sum(const T* x, const size_t& n) { return _sum_scalar(x, n); }
+template <class T> inline T _dot(const T* x, const T* y, const size_t& n) { return _dot_scalar(x, y, n); }
+template <class T> inline T _min(const T* x, const size_t& n) { return _min_scalar(x, n); }
+template <class T> inline T _max(const T* x, const size_t& n) { return _max_scalar(x, n); }
+template <class T> inline void _axpy(T* y, const T& a, const T* x, const size_t& n) { _axpy_scalar(y, a, x, n); }
+template <class T> inline void _add(T* y, const T* x, const size_t& n) { _add_scalar(y, x, n); }
+template <class T> inline void _mul(T* y, const T* x, const size_t& n) { _mul_scalar(y, x, n); }
+
+
+// public interface
+
+template <class T, class A>
+_EnableArithmetic<T, T> Sum(const Vector<T, A>& v) { return _sum(v.data(), v.size()); }
+
+template <class T, class A>
+_EnableArithmetic<T, T> MinValue(const Vector<T, A>& v) {
+    if(v.empty()) throw std::out_of_range("min of empty vector");
+    return _min(v.data(), v.size());
+}
+
+template <class T, class A>
+_EnableArithmetic<T, T> MaxValue(const Vector<T, A>& v) {
+    if(v.empty()) throw std::out_of_range("max of empty vector");
+    return _max(v.data(), v.size());
+}
+
+template <class T, class A>
+_EnableArithmetic<T, T> Dot(const Vector<T, A>& x, const Vector<T, A>& y) {
+    if(x.size() != y.size()) throw std::invalid_argument("vector size mismatch");
+    return _dot(x.data(), y.data(), x.size());
+}
+
+// y += a * x
+template <class T, class A>
+_EnableArithmetic<T> Axpy(Vector<T, A>& y, const T& a, const Vector<T, A>& x) {
+    if(x.size() != y.size()) throw std::invalid_argument("vector size mismatch");
+    _axpy(y.data(), a, x.data(), x.size());
+}
+
+// y += x (element-wise)
+template <class T, class A>
+_EnableArithmetic<T> Add(Vector<T, A>& y, const Vector<T, A>& x) {
+    if(x.size() != y.size()) throw std::invalid_argument("vector size mismatch");
+    _add(y.data(), x.data(), x.size());
+}
+
+// y *= x (element-wise)
+template <class T, class A>
+_EnableArithmetic<T> Mul(Vector<T, A>& y, const Vector<T, A>& x) {
+    if(x.size() != y.size()) throw std::invalid_argument("vector size mismatch");
+    _mul(y.data(), x.data(), x.size());
+}
+
+// inclusive scan in place (a loop-carried dependency, so it stays scalar but unchecked)
+template <class T, class A>
+_EnableArithmetic<T> PrefixSum(Vector<T, A>& v) {
+    T *x = v.data();
+    for(size_t i = 1; i < v.size(); ++i) x[i] += x[i - 1];
+}
+
+// branchless count over the raw buffer
+template <class T, class A, class Pred>
+_EnableArithmetic<T, size_t> CountIf(const Vector<T, A>& v, Pred pred) {
+    const T *x = v.data();
+    size_t cnt = 0;
+    for(size_t i = 0; i < v.size(); ++i) cnt += pred(x[i]) ? 1 : 0;
+    return cnt;
+}
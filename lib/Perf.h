@@ -0,0 +1,274 @@
+// performance probes: PERF_PROBE("name") at the top of a block charges the block's cycles, instructions,
+// cache misses and branch misses to name
+// compiled out unless PERF_PROBES is defined (cmake -DPERF_PROBES=ON), the macro then expands to nothing
+// counters come from perf_event_open (Linux, user space only), or the time stamp counter when that is not permitted
+// usage:
+//   void parse(...) {
+//       PERF_PROBE("parse");
+//       ...
+//   }
+//   PerfDump();   // one line per probe name on stderr
+// totals are kept per thread and merged when the thread exits (or calls PerfFlush),
+// so a report covers finished threads and the calling one
+// a probe inside another is counted in both, and each probe costs two counter reads (a syscall with perf_event)
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+
+// probe names, the library's own probes use the first few
+static const size_t PERF_SITES_MAX = 256;
+
+struct PerfTotals {
+    uint64_t calls;
+    uint64_t cycles;
+    uint64_t instructions;
+    uint64_t cache_misses;
+    uint64_t branch_misses;
+};
+
+#ifdef PERF_PROBES
+
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <ctime>
+#endif
+
+
+enum { _PERF_CYCLES, _PERF_INSTRUCTIONS, _PERF_CACHE_MISSES, _PERF_BRANCH_MISSES, _PERF_COUNTERS };
+
+// fallback clock: time stamp counter ticks, or nanoseconds where there is none
+inline uint64_t _PerfTicks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+// probe names and the totals of threads that are done
+class _PerfRegistry {
+public:
+    std::mutex mutex;
+    const char* names[PERF_SITES_MAX];
+    size_t count;
+    PerfTotals totals[PERF_SITES_MAX];
+
+    _PerfRegistry(): count{0}, totals{} { }
+
+    static _PerfRegistry& get() {
+        static _PerfRegistry registry;
+        return registry;
+    }
+
+    // one id per name, so every instantiation of a template shares its probe
+    size_t site(const char* name) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for(size_t i = 0; i < count; ++i) if(strcmp(names[i], name) == 0) return i;
+        if(count == PERF_SITES_MAX) throw std::overflow_error("too many perf probe names");
+        names[count] = name;
+        return count++;
+    }
+    // -1 if the name was never probed
+    long find(const char* name) {
+        for(size_t i = 0; i < count; ++i) if(strcmp(names[i], name) == 0) return i;
+        return -1;
+    }
+};
+
+inline void _PerfAdd(PerfTotals& to, const PerfTotals& from) {
+    to.calls += from.calls;
+    to.cycles += from.cycles;
+    to.instructions += from.instructions;
+    to.cache_misses += from.cache_misses;
+    to.branch_misses += from.branch_misses;
+}
+
+// the calling thread's counters and totals
+class _PerfThread {
+public:
+    // counter group of this thread, fds[_PERF_CYCLES] leads it (-1: not available)
+    int fds[_PERF_COUNTERS];
+    // position of every counter in a group read (-1: not opened)
+    int slots[_PERF_COUNTERS];
+    int opened;
+    PerfTotals totals[PERF_SITES_MAX];
+
+    _PerfThread(): opened{0}, totals{} {
+        // the registry outlives every thread's totals
+        _PerfRegistry::get();
+        for(int i = 0; i < _PERF_COUNTERS; ++i) fds[i] = slots[i] = -1;
+#if defined(__linux__)
+        static const uint64_t configs[_PERF_COUNTERS] = {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+        };
+        for(int i = 0; i < _PERF_COUNTERS; ++i) {
+            perf_event_attr attr;
+            memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[i];
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP;
+            // the group starts at once when the leader is enabled
+            attr.disabled = i == 0;
+            fds[i] = syscall(SYS_perf_event_open, &attr, 0, -1, i == 0 ? -1 : fds[0], PERF_FLAG_FD_CLOEXEC);
+            // without cycles there is no group, the rest is optional
+            if(fds[0] < 0) break;
+            if(fds[i] >= 0) slots[i] = opened++;
+        }
+        if(opened > 0) {
+            ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+    }
+    _PerfThread(const _PerfThread&) = delete;
+    _PerfThread& operator=(const _PerfThread&) = delete;
+    ~_PerfThread() {
+        flush();
+#if defined(__linux__)
+        for(int i = 0; i < _PERF_COUNTERS; ++i) if(fds[i] >= 0) close(fds[i]);
+#endif
+    }
+
+    static _PerfThread& local() {
+        static thread_local _PerfThread thread;
+        return thread;
+    }
+
+    // all counters now, the ones not available read 0
+    void read(uint64_t* values) {
+        for(int i = 0; i < _PERF_COUNTERS; ++i) values[i] = 0;
+#if defined(__linux__)
+        if(opened > 0) {
+            // number of counters, then their values in the order they were opened
+            uint64_t buf[1 + _PERF_COUNTERS];
+            if(::read(fds[0], buf, sizeof(buf)) > 0) {
+                for(int i = 0; i < _PERF_COUNTERS; ++i) if(slots[i] >= 0) values[i] = buf[1 + slots[i]];
+            }
+            return;
+        }
+#endif
+        values[_PERF_CYCLES] = _PerfTicks();
+    }
+
+    void flush() {
+        _PerfRegistry& registry = _PerfRegistry::get();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for(size_t i = 0; i < registry.count; ++i) {
+            _PerfAdd(registry.totals[i], totals[i]);
+            totals[i] = PerfTotals{};
+        }
+    }
+};
+
+
+// a probe name, registered once (PERF_PROBE keeps it in a function local static)
+class PerfSite {
+public:
+    const size_t id;
+    explicit PerfSite(const char* name): id{_PerfRegistry::get().site(name)} { }
+};
+
+// counts from construction to destruction
+class PerfScope {
+protected:
+    _PerfThread& _thread;
+    size_t _site;
+    uint64_t _start[_PERF_COUNTERS];
+
+public:
+    explicit PerfScope(const PerfSite& site): _thread(_PerfThread::local()), _site{site.id} { _thread.read(_start); }
+    PerfScope(const PerfScope&) = delete;
+    PerfScope& operator=(const PerfScope&) = delete;
+    ~PerfScope() {
+        uint64_t end[_PERF_COUNTERS];
+        _thread.read(end);
+        PerfTotals& t = _thread.totals[_site];
+        ++t.calls;
+        t.cycles += end[_PERF_CYCLES] - _start[_PERF_CYCLES];
+        t.instructions += end[_PERF_INSTRUCTIONS] - _start[_PERF_INSTRUCTIONS];
+        t.cache_misses += end[_PERF_CACHE_MISSES] - _start[_PERF_CACHE_MISSES];
+        t.branch_misses += end[_PERF_BRANCH_MISSES] - _start[_PERF_BRANCH_MISSES];
+    }
+};
+
+#define _PERF_CONCAT2(a, b) a##b
+#define _PERF_CONCAT(a, b) _PERF_CONCAT2(a, b)
+#define PERF_PROBE(name) \
+    static const PerfSite _PERF_CONCAT(_perf_site_, __LINE__)(name); \
+    PerfScope _PERF_CONCAT(_perf_scope_, __LINE__)(_PERF_CONCAT(_perf_site_, __LINE__))
+
+// this thread's totals go to the shared ones now (e.g. before a report from another thread)
+inline void PerfFlush() { _PerfThread::local().flush(); }
+
+// totals of name over finished threads and the calling one (all zero if it was never probed)
+inline PerfTotals PerfTotalsOf(const char* name) {
+    PerfFlush();
+    _PerfRegistry& registry = _PerfRegistry::get();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    long i = registry.find(name);
+    return i < 0 ? PerfTotals{} : registry.totals[i];
+}
+
+// drop every total
+inline void PerfReset() {
+    PerfFlush();
+    _PerfRegistry& registry = _PerfRegistry::get();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for(size_t i = 0; i < registry.count; ++i) registry.totals[i] = PerfTotals{};
+}
+
+// one line per probe name, with the calling thread's counter source
+inline void PerfDump(FILE* out = stderr) {
+    PerfFlush();
+    _PerfThread& thread = _PerfThread::local();
+    _PerfRegistry& registry = _PerfRegistry::get();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    fprintf(out, "perf probes (%s)\n", thread.opened > 0 ? "perf_event, user space" : "no perf_event: time stamp counter only");
+    fprintf(out, "%-24s %12s %16s %12s %16s %14s %14s\n",
+            "probe", "calls", "cycles", "cycles/call", "instructions", "cache misses", "branch misses");
+    for(size_t i = 0; i < registry.count; ++i) {
+        const PerfTotals& t = registry.totals[i];
+        if(t.calls == 0) continue;
+        fprintf(out, "%-24s %12llu %16llu %12.1f", registry.names[i],
+                (unsigned long long)t.calls, (unsigned long long)t.cycles, (double)t.cycles / t.calls);
+        const int counters[] = {_PERF_INSTRUCTIONS, _PERF_CACHE_MISSES, _PERF_BRANCH_MISSES};
+        const uint64_t values[] = {t.instructions, t.cache_misses, t.branch_misses};
+        const int widths[] = {16, 14, 14};
+        for(int k = 0; k < 3; ++k) {
+            if(thread.slots[counters[k]] >= 0) fprintf(out, " %*llu", widths[k], (unsigned long long)values[k]);
+            else fprintf(out, " %*s", widths[k], "-");
+        }
+        fprintf(out, "\n");
+    }
+}
+
+#else
+
+// disabled: no code, no data
+#define PERF_PROBE(name) ((void)0)
+
+inline void PerfFlush() { }
+inline PerfTotals PerfTotalsOf(const char*) { return PerfTotals{}; }
+inline void PerfReset() { }
+inline void PerfDump(FILE* = stderr) { }
+
+#endif
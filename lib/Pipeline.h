@@ -0,0 +1,160 @@
+// line pipeline stages on top of Coroutine.h: read -> filter -> transform -> write
+// lines travel in batches of views into one read buffer, so no stage copies a line until it transforms it
+// usage:
+//   ThreadPool pool;
+//   Channel<LineBatch> raw(pool, 8), kept(pool, 8, workers);
+//   Channel<String> text(pool, 8, workers);
+//   pool.spawn(ReadLines(in_fd, raw));
+//   for(size_t i = 0; i < workers; ++i) {
+//       pool.spawn(FilterLines(raw, kept, "^ERROR"));      // every worker closes kept once
+//       pool.spawn(TransformLines(kept, text, f));        // f(const StringView&, String&)
+//   }
+//   pool.spawn(WriteLines(text, out_fd));
+//   pool.wait();
+// channels, regexes and callables are referenced by the stages and must outlive pool.wait()
+// with several workers on one channel, batches may overtake each other (LineBatch::seq keeps the input order)
+// a stage that throws closes its output and cancels its input, so the stages around it wind down
+// and pool.wait() rethrows the exception
+
+#pragma once
+
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+#include <utility>
+
+#include <unistd.h>
+
+#include "Coroutine.h"
+#include "String.h"
+#include "Vector.h"
+#include "View.h"
+
+
+// lines of one read, '\n' replaced by '\0' in place so every view is terminated
+struct LineBatch {
+    Vector<char> text;
+    Vector<StringView> lines;
+    // position in the input, batches are numbered from 0
+    size_t seq;
+
+    LineBatch(): seq{0} { }
+};
+
+// views of the lines in [data, data + n), each '\n' is overwritten with '\0'
+// data[n] must be writable: it terminates a last line that has no '\n'
+// (coroutine parameters are taken by value, a reference would outlive its argument)
+inline Generator<StringView> SplitLines(char* data, const size_t n) {
+    char *p = data, *last = data + n;
+    while(p < last) {
+        char *nl = (char*)memchr(p, '\n', last - p);
+        if(nl == NULL) nl = last;
+        *nl = '\0';
+        co_yield StringView(p, nl - p);
+        p = nl + 1;
+    }
+}
+
+// all n bytes, retrying short writes
+inline void _WriteAll(const int& fd, const char* p, size_t n) {
+    while(n > 0) {
+        ssize_t w = ::write(fd, p, n);
+        if(w < 0) {
+            if(errno == EINTR) continue;
+            throw std::system_error(errno, std::generic_category(), "pipeline write");
+        }
+        p += w;
+        n -= w;
+    }
+}
+
+
+// reads fd in chunks of about chunk bytes, sends one batch of whole lines per chunk
+// a line cut by the chunk end is carried to the next batch, it is the only copy made
+inline Task<void> ReadLines(const int fd, Channel<LineBatch>& out, const size_t chunk = 1 << 16) {
+    ChannelCloser<LineBatch> closer(out);
+    Vector<char> carry;
+    size_t seq = 0;
+    for(;;) {
+        LineBatch batch;
+        batch.seq = seq++;
+        // carry, new bytes and room for a terminator
+        batch.text = Vector<char>(carry.size() + chunk + 1, 0);
+        if(!carry.empty()) memcpy(batch.text.data(), carry.data(), carry.size());
+        size_t n = carry.size();
+        ssize_t r;
+        while((r = ::read(fd, batch.text.data() + n, chunk)) < 0 && errno == EINTR) { }
+        if(r < 0) throw std::system_error(errno, std::generic_category(), "pipeline read");
+        n += r;
+        // keep whole lines, the tail after the last '\n' waits for more input (or ends the file)
+        size_t whole = n;
+        if(r > 0) {
+            while(whole > 0 && batch.text.at_unchecked(whole - 1) != '\n') --whole;
+        }
+        carry = Vector<char>(batch.text.data() + whole, batch.text.data() + n);
+        if(whole > 0) {
+            for(const StringView& line : SplitLines(batch.text.data(), whole)) batch.lines.push_back(line);
+            // cancelled downstream
+            if(!co_await out.send(std::move(batch))) break;
+        }
+        if(r == 0) break;
+    }
+}
+
+// drops the lines that do not match regex (String::match syntax), empty batches are not sent on
+inline Task<void> FilterLines(Channel<LineBatch>& in, Channel<LineBatch>& out, const char* regex) {
+    ChannelCloser<LineBatch> closer(out);
+    LineBatch batch;
+    try {
+        while(co_await in.receive(batch)) {
+            // compact in place
+            size_t kept = 0;
+            for(size_t i = 0; i < batch.lines.size(); ++i) {
+                if(batch.lines.at_unchecked(i).match(regex)) batch.lines.at_unchecked(kept++) = batch.lines.at_unchecked(i);
+            }
+            if(kept == 0) continue;
+            if(kept != batch.lines.size()) batch.lines.resize(kept);
+            // cancelled downstream, pass it upstream
+            if(!co_await out.send(std::move(batch))) {
+                in.cancel();
+                break;
+            }
+        }
+    } catch(...) {
+        in.cancel();
+        throw;
+    }
+}
+
+// f(line, text) appends whatever a line turns into, one String per batch is sent on
+template <class F>
+Task<void> TransformLines(Channel<LineBatch>& in, Channel<String>& out, F& f) {
+    ChannelCloser<String> closer(out);
+    LineBatch batch;
+    try {
+        while(co_await in.receive(batch)) {
+            String text;
+            text.reserve(batch.text.size());
+            for(size_t i = 0; i < batch.lines.size(); ++i) f(batch.lines.at_unchecked(i), text);
+            if(!co_await out.send(std::move(text))) {
+                in.cancel();
+                break;
+            }
+        }
+    } catch(...) {
+        in.cancel();
+        throw;
+    }
+}
+
+// writes every String as it arrives, one write per batch
+inline Task<void> WriteLines(Channel<String>& in, const int fd) {
+    String text;
+    try {
+        while(co_await in.receive(text)) _WriteAll(fd, text.c_str(), text.length());
+    } catch(...) {
+        // nobody reads the rest, release the senders
+        in.cancel();
+        throw;
+    }
+}
@@ -0,0 +1,259 @@
+// priority queue: d-ary heap stored in a Vector
+// with Arity 4 the children of a node share a cache line, and the tree is half as deep as a binary heap
+
+#pragma once
+
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+
+#include "Algorithm.h"
+#include "Vector.h"
+
+
+// sift routines shared by PriorityQueue and IndexedPriorityQueue
+// moved(i) is called whenever a[i] receives an element, so the indexed queue can track positions
+// both sift with a hole: the element is moved out once and written back once
+template <size_t Arity>
+struct _DaryHeap {
+    static_assert(Arity >= 2, "heap arity must be at least 2");
+
+    static constexpr size_t parent(const size_t& i) { return (i - 1) / Arity; }
+    static constexpr size_t first_child(const size_t& i) { return Arity * i + 1; }
+
+    // returns the final position
+    template <class T, class Compare, class Moved>
+    static size_t sift_up(T* a, size_t i, const Compare& comp, const Moved& moved) {
+        T tmp = std::move(a[i]);
+        while(i > 0) {
+            size_t p = parent(i);
+            if(!comp(tmp, a[p])) break;
+            a[i] = std::move(a[p]);
+            moved(i);
+            i = p;
+        }
+        a[i] = std::move(tmp);
+        moved(i);
+        return i;
+    }
+
+    template <class T, class Compare, class Moved>
+    static size_t sift_down(T* a, const size_t& n, size_t i, const Compare& comp, const Moved& moved) {
+        T tmp = std::move(a[i]);
+        for(;;) {
+            size_t c = first_child(i), best = c;
+            if(c >= n) break;
+            // all Arity children present: a fixed trip count the compiler unrolls
+            if(c + Arity <= n) {
+                for(size_t j = 1; j < Arity; ++j) best = comp(a[c + j], a[best]) ? c + j : best;
+            } else {
+                for(size_t j = c + 1; j < n; ++j) best = comp(a[j], a[best]) ? j : best;
+            }
+            if(!comp(a[best], tmp)) break;
+            a[i] = std::move(a[best]);
+            moved(i);
+            i = best;
+        }
+        a[i] = std::move(tmp);
+        moved(i);
+        return i;
+    }
+
+    // bottom-up, O(n)
+    template <class T, class Compare, class Moved>
+    static void heapify(T* a, const size_t& n, const Compare& comp, const Moved& moved) {
+        if(n < 2) return;
+        for(size_t i = parent(n - 1) + 1; i-- > 0; ) sift_down(a, n, i, comp, moved);
+    }
+};
+
+// no position tracking
+struct _NotMoved {
+    constexpr void operator()(const size_t&) const { }
+};
+
+
+// top() is the element Sort would put first (Less: smallest first, Greater: largest first)
+// usage:
+//   PriorityQueue<Deadline> timers;          // 4-ary, earliest deadline on top
+//   PriorityQueue<int, Greater, 2> q(std::move(v));   // binary max-heap over v, O(n)
+template <class T, class Compare = Less, size_t Arity = 4, class _Alloc = _Allocator<T>>
+class PriorityQueue {
+    typedef _DaryHeap<Arity> _Heap;
+
+protected:
+    Vector<T, _Alloc> _heap;
+    Compare _comp;
+
+public:
+    // default
+    PriorityQueue() { }
+    // bulk: takes the items over and heapifies them in place
+    explicit PriorityQueue(Vector<T, _Alloc>&& items) { heapify(std::move(items)); }
+    explicit PriorityQueue(const Vector<T, _Alloc>& items): PriorityQueue(Vector<T, _Alloc>(items)) { }
+    PriorityQueue(std::initializer_list<T> l): PriorityQueue(Vector<T, _Alloc>(l)) { }
+
+    // replaces the content, O(n)
+    void heapify(Vector<T, _Alloc>&& items) {
+        _heap = std::move(items);
+        _Heap::heapify(_heap.data(), _heap.size(), _comp, _NotMoved());
+    }
+
+    // size
+    size_t size() const { return _heap.size(); }
+    bool empty() const { return _heap.empty(); }
+    void reserve(const size_t& capacity) { _heap.reserve(capacity); }
+
+    // heap order, not sorted
+    const Vector<T, _Alloc>& items() const { return _heap; }
+
+    // access
+    const T& top() const {
+        if(_heap.empty()) throw std::out_of_range("priority queue is empty");
+        return _heap.data()[0];
+    }
+
+    // modify
+    void push(const T& item) {
+        _heap.push_back(item);
+        _Heap::sift_up(_heap.data(), _heap.size() - 1, _comp, _NotMoved());
+    }
+    void push(T&& item) {
+        _heap.push_back(std::move(item));
+        _Heap::sift_up(_heap.data(), _heap.size() - 1, _comp, _NotMoved());
+    }
+    void pop() {
+        if(_heap.empty()) throw std::underflow_error("priority queue pop underflow");
+        size_t n = _heap.size() - 1;
+        T *a = _heap.data();
+        if(n > 0) a[0] = std::move(a[n]);
+        _heap.pop_back();
+        if(n > 1) _Heap::sift_down(_heap.data(), n, 0, _comp, _NotMoved());
+    }
+    void clear() { _heap.clear(); }
+};
+
+
+// priority queue whose items can be reprioritized or removed through the handle push returned
+// usage:
+//   IndexedPriorityQueue<Deadline> timers;
+//   auto h = timers.push(t0);
+//   timers.decrease_key(h, t1);   // fires earlier
+//   timers.erase(h);              // cancelled
+template <class T, class Compare = Less, size_t Arity = 4, class _Alloc = _Allocator<T>>
+class IndexedPriorityQueue {
+    typedef _DaryHeap<Arity> _Heap;
+
+public:
+    typedef size_t Handle;
+
+    // position of a handle that is not in the queue
+    static const size_t npos = (size_t)-1;
+
+protected:
+    // the id travels with its value, so a sift touches one array
+    struct _Entry {
+        T value;
+        Handle id;
+    };
+    typedef Vector<_Entry, typename _Alloc::template rebind<_Entry>> _EntryVector;
+    typedef Vector<size_t, typename _Alloc::template rebind<size_t>> _IndexVector;
+
+    _EntryVector _heap;
+    // heap position of every handle ever issued (npos once popped or erased)
+    _IndexVector _pos;
+    // handles ready for reuse
+    _IndexVector _free;
+    Compare _comp;
+
+    bool _less(const _Entry& a, const _Entry& b) const { return _comp(a.value, b.value); }
+
+    // calls sift with a comparison on values and a callback that records positions
+    template <class Sift>
+    size_t _sift(const Sift& sift) {
+        _Entry *a = _heap.data();
+        size_t *pos = _pos.data();
+        return sift(a, [this](const _Entry& x, const _Entry& y) { return _less(x, y); },
+                    [a, pos](const size_t& i) { pos[a[i].id] = i; });
+    }
+    size_t _sift_up(const size_t& i) {
+        return _sift([i](_Entry* a, const auto& comp, const auto& moved) { return _Heap::sift_up(a, i, comp, moved); });
+    }
+    size_t _sift_down(const size_t& i) {
+        size_t n = _heap.size();
+        return _sift([i, n](_Entry* a, const auto& comp, const auto& moved) { return _Heap::sift_down(a, n, i, comp, moved); });
+    }
+
+    size_t _position(const Handle& h) const {
+        if(!contains(h)) throw std::out_of_range("priority queue handle not in queue");
+        return _pos.data()[h];
+    }
+    // take the entry at i out of the heap, its handle becomes free
+    void _remove_at(const size_t& i) {
+        _Entry *a = _heap.data();
+        size_t n = _heap.size() - 1;
+        Handle h = a[i].id;
+        if(i != n) a[i] = std::move(a[n]);
+        _heap.pop_back();
+        _pos.data()[h] = npos;
+        _free.push_back(h);
+        if(i != n && _sift_up(i) == i) _sift_down(i);
+    }
+    template <class U>
+    Handle _push(U&& item) {
+        Handle h;
+        if(_free.empty()) {
+            h = _pos.size();
+            _pos.push_back(npos);
+        } else {
+            h = _free.back();
+            _free.pop_back();
+        }
+        _heap.push_back(_Entry{std::forward<U>(item), h});
+        _sift_up(_heap.size() - 1);
+        return h;
+    }
+
+public:
+    // size
+    size_t size() const { return _heap.size(); }
+    bool empty() const { return _heap.empty(); }
+
+    bool contains(const Handle& h) const { return h < _pos.size() && _pos.data()[h] != npos; }
+    const T& value(const Handle& h) const { return _heap.data()[_position(h)].value; }
+
+    // access
+    const T& top() const {
+        if(_heap.empty()) throw std::out_of_range("priority queue is empty");
+        return _heap.data()[0].value;
+    }
+    Handle top_handle() const {
+        if(_heap.empty()) throw std::out_of_range("priority queue is empty");
+        return _heap.data()[0].id;
+    }
+
+    // modify, the handle stays valid until its item is popped or erased (then it may be reused)
+    Handle push(const T& item) { return _push(item); }
+    Handle push(T&& item) { return _push(std::move(item)); }
+    void pop() {
+        if(_heap.empty()) throw std::underflow_error("priority queue pop underflow");
+        _remove_at(0);
+    }
+    // move h towards the top, the new value must not order after the old one
+    void decrease_key(const Handle& h, const T& value) {
+        size_t i = _position(h);
+        _Entry& e = _heap.data()[i];
+        if(_comp(e.value, value)) throw std::invalid_argument("decrease_key would move the item away from the top");
+        e.value = value;
+        _sift_up(i);
+    }
+    void erase(const Handle& h) { _remove_at(_position(h)); }
+    void clear() {
+        _heap.clear();
+        _pos.clear();
+        _free.clear();
+    }
+};
+
+template <class T, class Compare, size_t Arity, class _Alloc>
+const size_t IndexedPriorityQueue<T, Compare, Arity, _Alloc>::npos;
@@ -0,0 +1,204 @@
+// shared string: copy-on-write string, copies share one buffer through an atomic refcount
+
+#pragma once
+
+#include <atomic>
+#include <new>
+#include <stdexcept>
+
+#include "Allocator.h"
+#include "Iterator.h"
+#include "String.h"
+
+
+template <class T, class Alloc>
+class _SharedString {
+public:
+    // read-only iteration, writes go through operator+= / operator[]
+    typedef _RandomIterator<const T> ConstIterator;
+
+protected:
+    // header of a shared block, the characters follow it in the same allocation
+    struct _Rep {
+        std::atomic<size_t> _refs;
+        size_t _len;
+        size_t _capacity;
+        // false once a mutable reference was handed out, copies must not share it any more
+        bool _shareable;
+
+        T* data() { return reinterpret_cast<T*>(this + 1); }
+    };
+
+    // the block is raw bytes, rebind the allocator to char
+    typedef typename Alloc::template rebind<char> _ByteAlloc;
+
+    _Rep *_rep;
+    _ByteAlloc _alloc;
+
+    static size_t _bytes(const size_t& capacity) { return sizeof(_Rep) + capacity * sizeof(T); }
+
+    static size_t _strlen(const T* s) {
+        size_t n = 0;
+        while(s[n] != (T)'\0') ++n;
+        return n;
+    }
+
+    // new unshared block holding a copy of s[0, len)
+    _Rep* _create(const T* s, const size_t& len, const size_t& capacity) {
+        _Rep *rep = reinterpret_cast<_Rep*>(_alloc.allocate(_bytes(capacity)));
+        new((void*)rep) _Rep();
+        rep->_refs = 1;
+        rep->_len = len;
+        rep->_capacity = capacity;
+        rep->_shareable = true;
+        T *p = rep->data();
+        for(size_t i = 0; i < len; ++i) p[i] = s[i];
+        p[len] = (T)'\0';
+        return rep;
+    }
+    void _release() {
+        if(_rep == NULL) return;
+        // the last owner frees, acq_rel orders every other owner's reads before it
+        if(_rep->_refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            size_t capacity = _rep->_capacity;
+            _rep->~_Rep();
+            _alloc.deallocate(reinterpret_cast<char*>(_rep), _bytes(capacity));
+        }
+        _rep = NULL;
+    }
+    // share s's block when allowed, otherwise deep copy
+    void _share(const _SharedString& s) {
+        if(s._rep == NULL) _rep = NULL;
+        else if(s._rep->_shareable) {
+            s._rep->_refs.fetch_add(1, std::memory_order_relaxed);
+            _rep = s._rep;
+        }
+        else _rep = _create(s._rep->data(), s._rep->_len, s._rep->_len + 1);
+    }
+    // make sure this owns its block alone with room for capacity chars (terminator included)
+    void _detach(const size_t& capacity) {
+        if(_rep != NULL && _rep->_refs.load(std::memory_order_acquire) == 1 && _rep->_capacity >= capacity) return;
+        size_t new_capacity = capacity;
+        if(_rep != NULL) {
+            // a shared block is copied at its size, a full one grows like String
+            if(_rep->_capacity >= capacity) new_capacity = _rep->_capacity;
+            else if(capacity < 2 * _rep->_capacity) new_capacity = 2 * _rep->_capacity;
+        }
+        _Rep *rep = _create(c_str(), length(), new_capacity);
+        _release();
+        _rep = rep;
+    }
+
+public:
+    // default (no allocation)
+    _SharedString(): _rep{NULL} { }
+    // from c str (one copy)
+    explicit _SharedString(const T* s): _rep{NULL} {
+        if(s == NULL) throw std::invalid_argument("cannot initialize with nullptr");
+        size_t len = _strlen(s);
+        if(len > 0) _rep = _create(s, len, len + 1);
+    }
+    // from string (one copy, explicit so the cost is visible)
+    explicit _SharedString(const _String<T, Alloc>& s): _rep{NULL} {
+        if(s.length() > 0) _rep = _create(s.c_str(), s.length(), s.length() + 1);
+    }
+    // copy is O(1)
+    _SharedString(const _SharedString& s): _alloc{s._alloc} { _share(s); }
+    // move
+    _SharedString(_SharedString&& s): _rep{s._rep}, _alloc{std::move(s._alloc)} { s._rep = NULL; }
+    ~_SharedString() { _release(); }
+
+    // copy assign
+    _SharedString& operator=(const _SharedString& s) {
+        if(&s != this && s._rep != _rep) {
+            _release();
+            _alloc = s._alloc;
+            _share(s);
+        }
+        return *this;
+    }
+    // move assign
+    _SharedString& operator=(_SharedString&& s) {
+        if(&s != this) {
+            _release();
+            _alloc = std::move(s._alloc);
+            _rep = s._rep;
+            s._rep = NULL;
+        }
+        return *this;
+    }
+
+    // back to an owning string (one copy)
+    _String<T, Alloc> to_string() const { return _String<T, Alloc>(c_str()); }
+
+    ConstIterator begin() const { return ConstIterator(c_str()); }
+    ConstIterator end() const { return ConstIterator(c_str() + length()); }
+
+    // c string
+    const T* c_str() const {
+        static const T empty = (T)'\0';
+        return _rep != NULL ? _rep->data() : &empty;
+    }
+    // len
+    size_t length() const { return _rep != NULL ? _rep->_len : 0; }
+    // number of strings sharing the buffer (0 when empty)
+    size_t use_count() const { return _rep != NULL ? _rep->_refs.load(std::memory_order_relaxed) : 0; }
+
+    // search
+    ConstIterator find(const T c) const {
+        const T *p = c_str();
+        size_t i;
+        for(i = 0; i < length(); ++i) {
+            if(p[i] == c) break;
+        }
+        return ConstIterator(p + i);
+    }
+
+    // append (detaches)
+    _SharedString& operator+=(const T c) {
+        _detach(length() + 2);
+        _rep->data()[_rep->_len++] = c;
+        _rep->data()[_rep->_len] = (T)'\0';
+        return *this;
+    }
+    _SharedString& operator+=(const _SharedString& s) {
+        if(s.length() == 0) return *this;
+        // keep s alive in case it shares this buffer
+        _SharedString tmp(s);
+        _detach(length() + tmp.length() + 1);
+        T *p = _rep->data() + _rep->_len;
+        for(size_t i = 0; i <= tmp.length(); ++i) p[i] = tmp.c_str()[i];
+        _rep->_len += tmp.length();
+        return *this;
+    }
+
+    // access
+    // the mutable version detaches and stops sharing the buffer, since the returned
+    // reference could otherwise write through to later copies
+    T& operator[](const int index) {
+        if(index < 0 || (size_t)index >= length()) throw std::out_of_range("string index out of range");
+        _detach(length() + 1);
+        _rep->_shareable = false;
+        return _rep->data()[index];
+    }
+    const T& operator[](const int index) const {
+        if(index < 0 || (size_t)index >= length()) throw std::out_of_range("string index out of range");
+        return _rep->data()[index];
+    }
+
+    // regex
+    bool match(const T* regex) const { return match_regex(regex, c_str()); }
+};
+
+
+// define the basic shared string
+typedef _SharedString<char, _Allocator<char>> SharedString;
+
+
+inline bool operator==(const SharedString& lhs, const SharedString& rhs) {
+    return lhs.c_str() == rhs.c_str() || strcmp(lhs.c_str(), rhs.c_str()) == 0;
+}
+
+inline std::ostream& operator<<(std::ostream& os, const SharedString& s) {
+    return os << s.c_str();
+}
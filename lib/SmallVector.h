@@ -0,0 +1,250 @@
+// small vector: up to N elements live inline, the heap is used only after overflow
+
+#pragma once
+
+#include <exception>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+
+#include "Algorithm.h"
+#include "Allocator.h"
+#include "Iterator.h"
+#include "Memory.h"
+
+
+template <class T, size_t N, class _Alloc = _Allocator<T>>
+class SmallVector {
+    static_assert(N > 0, "use Vector for no inline capacity");
+
+public:
+    // same iterators as Vector
+    typedef _RandomIterator<T> Iterator;
+    typedef _RandomReverseIterator<T> ReverseIterator;
+    typedef _RandomIterator<const T> ConstIterator;
+    typedef _RandomReverseIterator<const T> ConstReverseIterator;
+
+protected:
+    // raw inline storage, elements are constructed on demand
+    alignas(T) unsigned char _buffer[N * sizeof(T)];
+    T* _data;
+    size_t _capacity;
+    size_t _size;
+    _Alloc _alloc;
+
+    T* _inline() { return reinterpret_cast<T*>(_buffer); }
+    bool _is_inline() const { return _data == reinterpret_cast<const T*>(_buffer); }
+
+    void _destroy_all() {
+        DestroyN(_data, _size, _alloc);
+        _size = 0;
+    }
+    // give heap memory back and fall back to the inline buffer
+    void _release() {
+        if(!_is_inline()) _alloc.deallocate(_data, _capacity);
+        _data = _inline();
+        _capacity = N;
+    }
+    // move elements into a new block (inline if it fits)
+    void _relocate(const size_t& new_capacity) {
+        T *ret = new_capacity <= N ? _inline() : _alloc.allocate(new_capacity);
+        if(ret == _data) return;
+        Relocate(_data, _size, ret, _alloc);
+        if(!_is_inline()) _alloc.deallocate(_data, _capacity);
+        _data = ret;
+        _capacity = new_capacity <= N ? N : new_capacity;
+    }
+    // exact
+    void _reserve(const size_t& min_capacity) {
+        if(min_capacity > _capacity) _relocate(min_capacity);
+    }
+    // amortized, same growth as Vector
+    void _grow(const size_t& min_capacity) {
+        if(min_capacity > _capacity) _relocate(2 * min_capacity);
+    }
+    // take over v's elements, v is left empty (and inline)
+    void _steal(SmallVector& v) {
+        if(v._is_inline()) {
+            // inline elements cannot be stolen, move them one by one
+            _data = _inline();
+            _capacity = N;
+            Relocate(v._data, v._size, _data, _alloc);
+            _size = v._size;
+            v._size = 0;
+        } else {
+            _data = v._data;
+            _capacity = v._capacity;
+            _size = v._size;
+            v._data = v._inline();
+            v._capacity = N;
+            v._size = 0;
+        }
+    }
+
+public:
+    // default
+    SmallVector(): _data{_inline()}, _capacity{N}, _size{0} { }
+    // from size
+    SmallVector(const size_t& size, const T& value): _data{_inline()}, _capacity{N}, _size{0} {
+        _reserve(size);
+        for(size_t i = 0; i < size; ++i) _alloc.construct(_data + _size++, value);
+    }
+    // from list
+    SmallVector(std::initializer_list<T> l): _data{_inline()}, _capacity{N}, _size{0} {
+        _reserve(l.size());
+        for(typename std::initializer_list<T>::const_iterator it = l.begin(); it != l.end(); ++it)
+            _alloc.construct(_data + _size++, *it);
+    }
+    // copy (allocates only if v does not fit inline)
+    SmallVector(const SmallVector& v): _data{_inline()}, _capacity{N}, _size{0} {
+        if(v._size > N) {
+            _data = _alloc.allocate(v._size);
+            _capacity = v._size;
+        }
+        UninitializedCopy(v.begin(), v.end(), _data, _alloc);
+        _size = v._size;
+    }
+    template <
+        class InputIter,
+        // use only for iterators (pointers included), never for (size, value)
+        typename = std::enable_if_t<_IsIterator<InputIter>::value && !std::is_integral<InputIter>::value>
+    >
+    SmallVector(InputIter first, InputIter last): _data{_inline()}, _capacity{N}, _size{0} {
+        for(InputIter it = first; it != last; ++it) push_back(*it);
+    }
+    // move (the allocator follows the buffer it allocated)
+    SmallVector(SmallVector&& v): _alloc{std::move(v._alloc)} { _steal(v); }
+
+    ~SmallVector() {
+        _destroy_all();
+        _release();
+    }
+
+    // iterator
+    Iterator begin() { return Iterator(_data); }
+    ConstIterator begin() const { return ConstIterator(_data); }
+    Iterator end() { return Iterator(_data + _size); }
+    ConstIterator end() const { return ConstIterator(_data + _size); }
+
+    ReverseIterator rbegin() { return ReverseIterator(end()); }
+    ConstReverseIterator rbegin() const { return ConstReverseIterator(end()); }
+    ReverseIterator rend() { return ReverseIterator(begin()); }
+    ConstReverseIterator rend() const { return ConstReverseIterator(begin()); }
+
+    // copy assign (reuses the current storage when it is large enough)
+    SmallVector& operator=(const SmallVector& v) {
+        if(&v != this) {
+            _destroy_all();
+            if(v._size > _capacity) {
+                _release();
+                _reserve(v._size);
+            }
+            UninitializedCopy(v.begin(), v.end(), _data, _alloc);
+            _size = v._size;
+        }
+        return *this;
+    }
+
+    // move assign
+    SmallVector& operator=(SmallVector&& v) {
+        if(&v != this) {
+            _destroy_all();
+            _release();
+            _alloc = std::move(v._alloc);
+            _steal(v);
+        }
+        return *this;
+    }
+
+    // size
+    size_t size() const { return _size; }
+    size_t capacity() const { return _capacity; }
+    bool empty() const { return _size == 0; }
+    // true while no heap memory is held
+    bool is_inline() const { return _is_inline(); }
+
+    // data
+    T* data() { return _data; }
+    const T* data() const { return _data; }
+
+    // access
+    T& operator[](const int& index) {
+        if(index < 0 || (size_t)index >= _size) throw std::out_of_range("vector index out of range");
+        return _data[index];
+    }
+    const T& operator[](const int& index) const {
+        if(index < 0 || (size_t)index >= _size) throw std::out_of_range("vector index out of range");
+        return _data[index];
+    }
+    // no range check, for hot loops that already know their bounds
+    T& at_unchecked(const size_t& index) { return _data[index]; }
+    const T& at_unchecked(const size_t& index) const { return _data[index]; }
+    // use operator[] to enforce range check
+    T& front() { return operator[](0); }
+    T& back() { return operator[](_size - 1); }
+
+    // append with copy
+    void push_back(const T& item) {
+        if(_size + 1 > _capacity) {
+            // item may live in this vector, copy it before relocating
+            T tmp(item);
+            _grow(_size + 1);
+            _alloc.construct(_data + _size++, std::move(tmp));
+        }
+        else _alloc.construct(_data + _size++, item);
+    }
+    // append with move
+    void push_back(T&& item) {
+        if(_size + 1 > _alloc.max_size()) throw std::overflow_error("vector push_back overflow");
+        _grow(_size + 1);
+        _alloc.construct(_data + _size++, std::move(item));
+    }
+    // pop_back will destroy objects
+    void pop_back() {
+        if(_size == 0) throw std::underflow_error("vector pop_back underflow");
+        _alloc.destroy(_data + --_size);
+    }
+
+    // resize: old elements are kept, new ones are copies of value
+    void resize(const size_t& size, const T& value = T()) {
+        while(_size > size) _alloc.destroy(_data + --_size);
+        _reserve(size);
+        while(_size < size) _alloc.construct(_data + _size++, value);
+    }
+    // shrink capacity to size, moving back inline when possible
+    void shrink() { if(_capacity > N) _relocate(_size); }
+    // drop all elements and any heap memory
+    void clear() {
+        _destroy_all();
+        _release();
+    }
+
+    // insert (ranges must not alias this vector)
+    void insert(const Iterator& pos, const size_t& n, const T& item) {
+        size_t at = pos.base() - _data;
+        T tmp(item);
+        _open(at, n);
+        for(size_t i = 0; i < n; ++i) _alloc.construct(_data + at + i, tmp);
+    }
+    template <class InputIter, typename = std::enable_if_t<_IsIterator<InputIter>::value && !std::is_integral<InputIter>::value>>
+    void insert(const Iterator& pos, InputIter first, InputIter last) {
+        if constexpr (_HasCategory<InputIter, std::forward_iterator_tag>::value) {
+            // size known up front: one opening, one copy
+            size_t at = pos.base() - _data, n = Distance(first, last);
+            _open(at, n);
+            UninitializedCopy(first, last, _data + at, _alloc);
+        } else {
+            // single pass: buffer the items, then move them in as a counted range
+            SmallVector tmp(first, last);
+            insert(pos, std::make_move_iterator(tmp.begin()), std::make_move_iterator(tmp.end()));
+        }
+    }
+
+protected:
+    // move [at, size) back by n, leaving [at, at + n) unconstructed
+    void _open(const size_t& at, const size_t& n) {
+        _grow(_size + n);
+        Relocate(_data + at, _size - at, _data + at + n, _alloc);
+        _size += n;
+    }
+};
@@ -0,0 +1,166 @@
+// sorting a Vector with the method that suits its element type, ascending:
+//   integers   LSD radix sort on bytes, a pass is skipped when every key has the same byte there
+//   String     multikey quicksort: three way partitions on one char at a time, no full string compares
+//              (chars compare as unsigned values up to length(), embedded NULs included, a prefix goes first)
+//   the rest   Sort (pattern defeating quicksort, operator<)
+// the radix sort needs as many elements of scratch as it sorts: pass a Vector that is kept between calls,
+// it grows once and later sorts of at most as many keys allocate nothing
+// usage:
+//   Vector<uint64_t> keys = ..., scratch;
+//   SortVector(keys, scratch);
+//   SortVector(names);                            // Vector<String>, in place
+//   StableSortVector(rows, row_scratch, by_date);
+
+#pragma once
+
+#include <cstring>
+#include <type_traits>
+
+#include "Algorithm.h"
+#include "String.h"
+#include "Vector.h"
+
+
+// integer types the radix sort handles (bool has a single bit of key)
+template <class T>
+using _IsRadixKey = std::integral_constant<bool, std::is_integral<T>::value && !std::is_same<T, bool>::value>;
+
+template <class T>
+struct _IsString: std::false_type { };
+
+template <class C, class Alloc>
+struct _IsString<_String<C, Alloc>>: std::true_type { };
+
+// unsigned key with the order of x (signed types get their sign bit flipped)
+template <class T>
+constexpr std::make_unsigned_t<T> _RadixKey(const T& x) {
+    typedef std::make_unsigned_t<T> U;
+    if constexpr (std::is_signed<T>::value) return (U)x ^ ((U)1 << (8 * sizeof(T) - 1));
+    else return x;
+}
+
+// ranges shorter than this go to Sort, below it the histograms cost more than they save
+static const size_t _RADIX_MIN = 256;
+
+
+// stable LSD radix sort of n integers, scratch points to n elements
+template <class T>
+void RadixSort(T* data, const size_t& n, T* scratch) {
+    static_assert(_IsRadixKey<T>::value, "radix sort needs integer keys");
+    const size_t DIGITS = sizeof(T);
+    // every digit's histogram in one read pass
+    size_t counts[DIGITS][256];
+    memset(counts, 0, sizeof(counts));
+    for(size_t i = 0; i < n; ++i) {
+        auto key = _RadixKey(data[i]);
+        for(size_t d = 0; d < DIGITS; ++d) ++counts[d][(key >> (8 * d)) & 0xff];
+    }
+    T *from = data, *to = scratch;
+    for(size_t d = 0; d < DIGITS; ++d) {
+        size_t *count = counts[d];
+        // all keys share this byte, the pass would only copy
+        if(n == 0 || count[(_RadixKey(from[0]) >> (8 * d)) & 0xff] == n) continue;
+        size_t sum = 0;
+        for(size_t b = 0; b < 256; ++b) {
+            size_t c = count[b];
+            count[b] = sum;
+            sum += c;
+        }
+        for(size_t i = 0; i < n; ++i) to[count[(_RadixKey(from[i]) >> (8 * d)) & 0xff]++] = from[i];
+        T *tmp = from;
+        from = to;
+        to = tmp;
+    }
+    if(from != data) memcpy(data, from, n * sizeof(T));
+}
+
+
+// char d of s as an unsigned key plus one, 0 past the end (so a NUL inside s still orders after the end)
+template <class C, class Alloc>
+inline size_t _CharAt(const _String<C, Alloc>& s, const size_t& d) {
+    return d < s.length() ? (size_t)(std::make_unsigned_t<C>)s.c_str()[d] + 1 : 0;
+}
+
+// strings that agree on their first d chars, compared from there on
+template <class C, class Alloc>
+inline bool _SuffixLess(const _String<C, Alloc>& a, const _String<C, Alloc>& b, size_t d) {
+    for(;; ++d) {
+        auto x = _CharAt(a, d), y = _CharAt(b, d);
+        if(x != y) return x < y;
+        if(x == 0) return false;
+    }
+}
+
+// multikey quicksort (Bentley, Sedgewick) of strings that agree on their first d chars
+// recurses into the two smaller of the <, = and > parts and loops on the largest, so the stack stays O(log n)
+template <class C, class Alloc>
+void _MultikeySort(_String<C, Alloc>* a, size_t n, size_t d) {
+    while(n > 16) {
+        // median of three chars as the pivot
+        auto x = _CharAt(a[0], d), y = _CharAt(a[n / 2], d), z = _CharAt(a[n - 1], d);
+        auto pivot = x < y ? (y < z ? y : (x < z ? z : x)) : (x < z ? x : (y < z ? z : y));
+        // [0, lt) < pivot, [lt, gt) == pivot, [gt, n) > pivot
+        size_t lt = 0, i = 0, gt = n;
+        while(i < gt) {
+            auto c = _CharAt(a[i], d);
+            if(c < pivot) a[lt++].swap(a[i++]);
+            else if(pivot < c) a[i].swap(a[--gt]);
+            else ++i;
+        }
+        // equal strings once the pivot is past their end
+        size_t eq = pivot == 0 ? 0 : gt - lt, less = lt, greater = n - gt;
+        if(eq >= less && eq >= greater) {
+            _MultikeySort(a, less, d);
+            _MultikeySort(a + gt, greater, d);
+            a += lt;
+            n = eq;
+            ++d;
+        } else if(less >= greater) {
+            _MultikeySort(a + lt, eq, d + 1);
+            _MultikeySort(a + gt, greater, d);
+            n = less;
+        } else {
+            _MultikeySort(a, less, d);
+            _MultikeySort(a + lt, eq, d + 1);
+            a += gt;
+            n = greater;
+        }
+    }
+    // short: insertion sort, comparing from d
+    for(size_t i = 1; i < n; ++i) {
+        for(size_t j = i; j > 0 && _SuffixLess(a[j], a[j - 1], d); --j) a[j].swap(a[j - 1]);
+    }
+}
+
+// strings by their chars as unsigned values (strcmp order, but over length() chars), in place
+template <class C, class Alloc>
+void StringSort(_String<C, Alloc>* data, const size_t& n) { _MultikeySort(data, n, 0); }
+
+
+// sorts v ascending, integer keys take a scratch Vector that is resized to v.size() when shorter
+template <class T, class Alloc, class ScratchAlloc>
+void SortVector(Vector<T, Alloc>& v, Vector<T, ScratchAlloc>& scratch) {
+    if constexpr (_IsRadixKey<T>::value) {
+        if(v.size() < _RADIX_MIN) Sort(v.data(), v.data() + v.size());
+        else {
+            if(scratch.size() < v.size()) scratch.resize(v.size());
+            RadixSort(v.data(), v.size(), scratch.data());
+        }
+    }
+    else if constexpr (_IsString<T>::value) StringSort(v.data(), v.size());
+    else Sort(v.data(), v.data() + v.size());
+}
+
+// same, the radix sort allocates its scratch for this call
+template <class T, class Alloc>
+void SortVector(Vector<T, Alloc>& v) {
+    Vector<T, Alloc> scratch;
+    SortVector(v, scratch);
+}
+
+// stable sort by comp, scratch is grown to v.size() copies of T() when shorter (T needs a default constructor)
+template <class T, class Alloc, class ScratchAlloc, class Compare = Less>
+void StableSortVector(Vector<T, Alloc>& v, Vector<T, ScratchAlloc>& scratch, Compare comp = Compare()) {
+    if(scratch.size() < v.size()) scratch = Vector<T, ScratchAlloc>(v.size(), T());
+    StableSort(v.data(), v.data() + v.size(), scratch.data(), comp);
+}
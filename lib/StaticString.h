@@ -0,0 +1,123 @@
+// static string: up to N chars inline, no allocation, usable in constant expressions
+
+#pragma once
+
+#include <stdexcept>
+
+#include "Iterator.h"
+#include "String.h"
+
+
+// usage:
+//   constexpr StaticString kw("select");   // StaticString<6>
+//   constexpr auto both = kw + StaticString(" *");     // StaticString<8>
+template <size_t N>
+class StaticString {
+public:
+    typedef _RandomIterator<char> Iterator;
+    typedef _RandomIterator<const char> ConstIterator;
+
+protected:
+    // always terminated, so c_str() needs no copy
+    char _data[N + 1]{};
+    size_t _len;
+
+public:
+    // default
+    constexpr StaticString(): _len{0} { }
+    // from c str
+    constexpr StaticString(const char* s): _len{0} {
+        if(s == NULL) throw std::invalid_argument("cannot initialize with nullptr");
+        while(s[_len] != '\0') {
+            if(_len == N) throw std::overflow_error("static string capacity exceeded");
+            _data[_len] = s[_len];
+            ++_len;
+        }
+    }
+    // from a shorter (or equal) static string
+    template <size_t M>
+    constexpr StaticString(const StaticString<M>& s): _len{0} {
+        if(s.length() > N) throw std::overflow_error("static string capacity exceeded");
+        for(; _len < s.length(); ++_len) _data[_len] = s.c_str()[_len];
+    }
+
+    constexpr Iterator begin() { return Iterator(_data); }
+    constexpr ConstIterator begin() const { return ConstIterator(_data); }
+    constexpr Iterator end() { return Iterator(_data + _len); }
+    constexpr ConstIterator end() const { return ConstIterator(_data + _len); }
+
+    // search
+    constexpr ConstIterator find(const char c) const {
+        size_t i = 0;
+        while(i < _len && _data[i] != c) ++i;
+        return ConstIterator(_data + i);
+    }
+
+    // c string
+    constexpr const char* c_str() const { return _data; }
+    // len
+    constexpr size_t length() const { return _len; }
+    constexpr size_t capacity() const { return N; }
+
+    // append
+    constexpr StaticString& operator+=(const char c) {
+        if(_len == N) throw std::overflow_error("static string capacity exceeded");
+        _data[_len++] = c;
+        _data[_len] = '\0';
+        return *this;
+    }
+    template <size_t M>
+    constexpr StaticString& operator+=(const StaticString<M>& s) {
+        if(_len + s.length() > N) throw std::overflow_error("static string capacity exceeded");
+        for(size_t i = 0; i < s.length(); ++i) _data[_len++] = s.c_str()[i];
+        _data[_len] = '\0';
+        return *this;
+    }
+
+    // access
+    constexpr char& operator[](const size_t& index) {
+        if(index >= _len) throw std::out_of_range("string index out of range");
+        return _data[index];
+    }
+    constexpr const char& operator[](const size_t& index) const {
+        if(index >= _len) throw std::out_of_range("string index out of range");
+        return _data[index];
+    }
+
+    // runtime copy (one allocation), use c_str() where a const char* is enough
+    String to_string() const { return String(_data); }
+
+    // regex (runtime only)
+    bool match(const char* regex) const { return match_regex(regex, _data); }
+};
+
+// StaticString("abc") deduces StaticString<3>
+template <size_t M>
+StaticString(const char (&)[M]) -> StaticString<M - 1>;
+
+
+template <size_t N, size_t M>
+constexpr bool operator==(const StaticString<N>& lhs, const StaticString<M>& rhs) {
+    if(lhs.length() != rhs.length()) return false;
+    for(size_t i = 0; i < lhs.length(); ++i) {
+        if(lhs.c_str()[i] != rhs.c_str()[i]) return false;
+    }
+    return true;
+}
+
+template <size_t N>
+constexpr bool operator==(const StaticString<N>& lhs, const char* rhs) {
+    size_t i = 0;
+    for(; i < lhs.length(); ++i) {
+        if(lhs.c_str()[i] != rhs[i]) return false;
+    }
+    return rhs[i] == '\0';
+}
+
+// capacity of the result is the sum of both
+template <size_t N, size_t M>
+constexpr StaticString<N + M> operator+(const StaticString<N>& lhs, const StaticString<M>& rhs) {
+    StaticString<N + M> ret(lhs);
+    ret += rhs;
+    return ret;
+}
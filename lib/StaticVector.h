@@ -0,0 +1,117 @@
+// static vector: fixed capacity, no allocation, usable in constant expressions
+
+#pragma once
+
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+
+#include "Algorithm.h"
+#include "Iterator.h"
+#include "Vector.h"
+
+
+// T must be a literal type with a default constructor (every slot is value-initialized)
+// usage:
+//   constexpr auto table = [] { StaticVector<int, 4> v{3, 1, 2}; Sort(v.begin(), v.end()); return v; }();
+template <class T, size_t N>
+class StaticVector {
+public:
+    typedef _RandomIterator<T> Iterator;
+    typedef _RandomReverseIterator<T> ReverseIterator;
+    typedef _RandomIterator<const T> ConstIterator;
+    typedef _RandomReverseIterator<const T> ConstReverseIterator;
+
+protected:
+    T _data[N == 0 ? 1 : N]{};
+    size_t _size;
+
+public:
+    // default
+    constexpr StaticVector(): _size{0} { }
+    // from size
+    constexpr StaticVector(const size_t& size, const T& value): _size{0} {
+        if(size > N) throw std::overflow_error("static vector capacity exceeded");
+        for(size_t i = 0; i < size; ++i) _data[_size++] = value;
+    }
+    // from list
+    constexpr StaticVector(std::initializer_list<T> l): _size{0} {
+        if(l.size() > N) throw std::overflow_error("static vector capacity exceeded");
+        for(const T *it = l.begin(); it != l.end(); ++it) _data[_size++] = *it;
+    }
+
+    // iterator
+    constexpr Iterator begin() { return Iterator(_data); }
+    constexpr ConstIterator begin() const { return ConstIterator(_data); }
+    constexpr Iterator end() { return Iterator(_data + _size); }
+    constexpr ConstIterator end() const { return ConstIterator(_data + _size); }
+
+    constexpr ReverseIterator rbegin() { return ReverseIterator(end()); }
+    constexpr ConstReverseIterator rbegin() const { return ConstReverseIterator(end()); }
+    constexpr ReverseIterator rend() { return ReverseIterator(begin()); }
+    constexpr ConstReverseIterator rend() const { return ConstReverseIterator(begin()); }
+
+    // size
+    constexpr size_t size() const { return _size; }
+    constexpr size_t capacity() const { return N; }
+    constexpr bool empty() const { return _size == 0; }
+
+    // data
+    constexpr T* data() { return _data; }
+    constexpr const T* data() const { return _data; }
+
+    // access
+    constexpr T& operator[](const size_t& index) {
+        if(index >= _size) throw std::out_of_range("vector index out of range");
+        return _data[index];
+    }
+    constexpr const T& operator[](const size_t& index) const {
+        if(index >= _size) throw std::out_of_range("vector index out of range");
+        return _data[index];
+    }
+    constexpr T& at_unchecked(const size_t& index) { return _data[index]; }
+    constexpr const T& at_unchecked(const size_t& index) const { return _data[index]; }
+    constexpr T& front() { return operator[](0); }
+    constexpr T& back() { return operator[](_size - 1); }
+
+    // modify
+    constexpr void push_back(const T& item) {
+        if(_size == N) throw std::overflow_error("static vector capacity exceeded");
+        _data[_size++] = item;
+    }
+    constexpr void push_back(T&& item) {
+        if(_size == N) throw std::overflow_error("static vector capacity exceeded");
+        _data[_size++] = std::move(item);
+    }
+    // the slot keeps its (moved from) value until it is overwritten
+    constexpr void pop_back() {
+        if(_size == 0) throw std::underflow_error("vector pop_back underflow");
+        --_size;
+    }
+    constexpr void clear() { _size = 0; }
+
+    // runtime copies, one allocation each
+    // a constexpr table stays in read-only data, prefer data()/size() or iterators over converting it
+    Vector<T> to_vector() const & {
+        Vector<T> ret;
+        ret.reserve(_size);
+        for(size_t i = 0; i < _size; ++i) ret.push_back(_data[i]);
+        return ret;
+    }
+    // elements are moved out of a temporary instead of copied
+    Vector<T> to_vector() && {
+        Vector<T> ret;
+        ret.reserve(_size);
+        for(size_t i = 0; i < _size; ++i) ret.push_back(std::move(_data[i]));
+        return ret;
+    }
+};
+
+template <class T, size_t N>
+constexpr bool operator==(const StaticVector<T, N>& lhs, const StaticVector<T, N>& rhs) {
+    if(lhs.size() != rhs.size()) return false;
+    for(size_t i = 0; i < lhs.size(); ++i) {
+        if(!(lhs.at_unchecked(i) == rhs.at_unchecked(i))) return false;
+    }
+    return true;
+}
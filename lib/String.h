@@ -2,11 +2,16 @@
 
 #pragma once
 
+#include <cstring>
 #include <iostream>
 #include <stdexcept>
 
+#include "Algorithm.h"
 #include "Allocator.h"
+#include "Charconv.h"
 #include "Iterator.h"
+#include "Memory.h"
+#include "Perf.h"
 
 
 template <class T, class Alloc>
@@ -26,10 +31,25 @@ protected:
     // allocator
     Alloc _alloc;
 
-    void strcpy(T* dst, const T* src) {
-        size_t i = 0;
-        while(src[i] != (T)'\0') dst[i] = src[i], ++i;
-        dst[i] = (T)'\0';
+    // copy n chars and terminate, the length is always known so this is a single memcpy
+    void _copy(T* dst, const T* src, const size_t& n) {
+        UninitializedCopy(src, src + n, dst, _alloc);
+        dst[n] = (T)'\0';
+    }
+    // room for n chars and the terminator, at least doubling so repeated appends stay amortized O(1)
+    void _grow(const size_t& n) {
+        if(n < _capacity) return;
+        reserve(n < 2 * _capacity ? 2 * _capacity - 1 : n);
+    }
+    // the whole string must be the number unless pos is given, then parsing starts and ends at *pos
+    const T* _parse_begin(const size_t* pos) const {
+        if(pos != NULL && *pos > _len) throw std::out_of_range("string index out of range");
+        return _data + (pos != NULL ? *pos : 0);
+    }
+    const T* _parse_end(const T* end, size_t* pos) const {
+        if(pos != NULL) *pos = end - _data;
+        else if(end != _data + _len) throw std::invalid_argument("not a number");
+        return end;
     }
 
 public:
@@ -44,22 +64,22 @@ public:
         _len = strlen(s);
         _capacity = _len + 1;
         _data = _alloc.allocate(_capacity);
-        strcpy(_data, s);
+        _copy(_data, s, _len);
     }
     // copy
     _String(const _String& s): _len{s._len}, _capacity{s._capacity}, _alloc{s._alloc} {
         _data = _alloc.allocate(_capacity);
-        strcpy(_data, s._data);
+        _copy(_data, s._data, s._len);
     }
     // move
-    _String(_String&& s): _len{s._len}, _capacity{s._capacity}, _alloc{s._alloc} {
+    _String(_String&& s): _len{s._len}, _capacity{s._capacity}, _alloc{std::move(s._alloc)} {
         _data = s._data;
         s._data = NULL;
         s._len = 0;
         s._capacity = 0;
     }
     ~_String() {
-        for(size_t i = 0; i < _capacity; ++i) _alloc.destroy(_data + i);
+        DestroyN(_data, _capacity, _alloc);
         _alloc.deallocate(_data, _capacity);
         _data = NULL;
         _len = 0;
@@ -83,11 +103,11 @@ public:
     // copy assign
     _String& operator=(const _String& s) {
         if(&s != this) {
-            for(size_t i = 0; i < _capacity; ++i) _alloc.destroy(_data + i);
+            DestroyN(_data, _capacity, _alloc);
             _alloc.deallocate(_data, _capacity);
             _data = _alloc.allocate(s._capacity);
             _capacity = s._capacity;
-            strcpy(_data, s._data);
+            _copy(_data, s._data, s._len);
             _len = s._len;
         }
         return *this;
@@ -95,8 +115,9 @@ public:
     // move assign
     _String& operator=(_String&& s) {
         if(&s != this) {
-            for(size_t i = 0; i < _capacity; ++i) _alloc.destroy(_data + i);
+            DestroyN(_data, _capacity, _alloc);
             _alloc.deallocate(_data, _capacity);
+            _alloc = std::move(s._alloc);
             _data = s._data;
             // set this to NULL to avoid repeated destruction
             s._data = NULL;
@@ -116,36 +137,87 @@ public:
 
     // append
     _String& operator+=(const T c) {
+        PERF_PROBE("String::operator+=");
         if(_len + 1 >= _capacity) {
             // double capacity if theres no space
             T* new_data = _alloc.allocate(_capacity * 2);
-            strcpy(new_data, _data);
-            for(size_t i = 0; i < _capacity; ++i)  _alloc.destroy(_data + i);
+            _copy(new_data, _data, _len);
+            DestroyN(_data, _capacity, _alloc);
             _alloc.deallocate(_data, _capacity);
             _data = new_data;
             // make sure allocation is a success before changing the value of capacity
             _capacity *= 2;
         }
         _data[_len++] = c;
+        _data[_len] = (T)'\0';
         return *this;
     }
 
     _String& operator+=(const _String& s) {
+        PERF_PROBE("String::operator+=");
         if(_len + s._len >= _capacity) {
             T* new_data = _alloc.allocate(_capacity + s._capacity);
             // destroy & copy old
-            strcpy(new_data, _data);
-            for(size_t i = 0; i < _capacity; ++i) _alloc.destroy(_data + i);
+            _copy(new_data, _data, _len);
+            DestroyN(_data, _capacity, _alloc);
             _alloc.deallocate(_data, _capacity);
             _data = new_data;
             _capacity += s._capacity;
         }
         // copy new
-        strcpy(_data + _len, s._data);
+        _copy(_data + _len, s._data, s._len);
         _len += s._len;
         return *this;
     }
 
+    // exchange contents, no allocation (the allocators are moved, so their state goes with the buffers)
+    void swap(_String& s) {
+        Swap(_data, s._data);
+        Swap(_len, s._len);
+        Swap(_capacity, s._capacity);
+        Swap(_alloc, s._alloc);
+    }
+
+    // capacity for n chars (the terminator is extra), never shrinks
+    void reserve(const size_t& n) {
+        if(n < _capacity) return;
+        T* new_data = _alloc.allocate(n + 1);
+        _copy(new_data, _data, _len);
+        DestroyN(_data, _capacity, _alloc);
+        _alloc.deallocate(_data, _capacity);
+        _data = new_data;
+        _capacity = n + 1;
+    }
+    size_t capacity() const { return _capacity == 0 ? 0 : _capacity - 1; }
+
+    // numbers are written straight into the buffer, see Charconv.h
+    template <class I, class = std::enable_if_t<std::is_integral<I>::value>>
+    _String& append_int(const I& value) {
+        _grow(_len + INT_CHARS_MAX);
+        _len = ToChars(_data + _len, value) - _data;
+        _data[_len] = (T)'\0';
+        return *this;
+    }
+    // shortest text that reads back to the same double
+    _String& append_double(const double& value) {
+        _grow(_len + DOUBLE_CHARS_MAX);
+        _len = ToChars(_data + _len, value) - _data;
+        _data[_len] = (T)'\0';
+        return *this;
+    }
+    template <class I = long long, class = std::enable_if_t<std::is_integral<I>::value>>
+    I parse_int(size_t* pos = NULL) const {
+        I ret;
+        _parse_end(ParseInt(_parse_begin(pos), _data + _len, ret), pos);
+        return ret;
+    }
+    double parse_double(size_t* pos = NULL) const {
+        double ret;
+        // the terminator is part of the range, so long numbers never need copying (it is never part of a number)
+        _parse_end(ParseDouble(_parse_begin(pos), _data + _len + 1, ret), pos);
+        return ret;
+    }
+
     // cast
     explicit operator T*() const { return _data; }
 
@@ -204,6 +276,7 @@ bool match_any(const char c, const char* regex, const char* text) {
 }
 
 bool match_regex(const char* regex, const char* text) {
+    PERF_PROBE("match_regex");
     // check ^ specifier
     if(regex[0] == '^') return match_start(regex + 1, text);
     do {
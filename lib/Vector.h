@@ -4,10 +4,13 @@
 
 #include <exception>
 #include <initializer_list>
+#include <iterator>
 
 #include "Algorithm.h"
 #include "Allocator.h"
 #include "Iterator.h"
+#include "Memory.h"
+#include "Perf.h"
 
 
 template <class T, class _Alloc = _Allocator<T>>
@@ -24,51 +27,72 @@ protected:
     size_t _size;
     _Alloc _alloc;
 
-    // re-allocation
+    // re-allocation (elements are moved, or memmoved when trivially copyable)
     void _resize(const size_t& old_size, const size_t& old_capacity, const size_t& new_size) {
+        PERF_PROBE("Vector::_resize");
         T *ret = _alloc.allocate(new_size);
-        // enforce copying instead of moving
-        for(int i = 0; i < Min(old_size, new_size); ++i) _alloc.construct(ret + i, std::move(*(_data + i)));
-        for(int i = old_size - 1; i >= 0; --i) _alloc.destroy(_data + i);
+        size_t keep = Min(old_size, new_size);
+        DestroyN(_data + keep, old_size - keep, _alloc);
+        Relocate(_data, keep, ret, _alloc);
         _alloc.deallocate(_data, old_capacity);
         _data = ret;
     }
+    // move [at, size) back by n, leaving [at, at + n) unconstructed
+    void _open(const size_t& at, const size_t& n) {
+        if(_size + n > _capacity) {
+            // relocate both halves straight into the new buffer
+            size_t new_capacity = 2 * (_size + n);
+            T *ret = _alloc.allocate(new_capacity);
+            Relocate(_data, at, ret, _alloc);
+            Relocate(_data + at, _size - at, ret + at + n, _alloc);
+            _alloc.deallocate(_data, _capacity);
+            _data = ret;
+            _capacity = new_capacity;
+        }
+        else Relocate(_data + at, _size - at, _data + at + n, _alloc);
+        _size += n;
+    }
 
 public:
     // default
     Vector(): _data{NULL}, _capacity{0}, _size{0} { }
     // from size
-    Vector(const size_t& size, const T& value): _capacity{size}, _size{0} {
+    Vector(const size_t& size, const T& value): _capacity{size}, _size{size} {
         _data = _alloc.allocate(size);
-        for(int i = 0; i < size; ++i) _alloc.construct(_data + _size++, value);
+        UninitializedFill(_data, size, value, _alloc);
     }
     // from list
-    Vector(std::initializer_list<T> l): _capacity{l.size()}, _size{0} {
+    Vector(std::initializer_list<T> l): _capacity{l.size()}, _size{l.size()} {
         _data = _alloc.allocate(l.size());
-        for(typename std::initializer_list<T>::const_iterator it = l.begin(); it != l.end(); ++it)
-            _alloc.construct(_data + _size++, *it);
+        UninitializedCopy(l.begin(), l.end(), _data, _alloc);
     }
     // copy (_capacity is not copied)
-    Vector(const Vector& v): _capacity{v._size}, _size{0} {
+    Vector(const Vector& v): _capacity{v._size}, _size{v._size} {
         _data = _alloc.allocate(v._size);
-        for(ConstIterator it = v.begin(); it != v.end(); ++it) _alloc.construct(_data + _size++, *it);
+        UninitializedCopy(v.begin(), v.end(), _data, _alloc);
     }
     template <
-        class InputIter, 
-        // use only if template derives from _Iterator<T>
-        typename = std::enable_if_t<std::is_base_of<_Iterator<T>, InputIter>::value>
+        class InputIter,
+        // use only for iterators (pointers included), never for (size, value)
+        typename = std::enable_if_t<_IsIterator<InputIter>::value && !std::is_integral<InputIter>::value>
     >
-    Vector(const InputIter& first, const InputIter& last): _data{NULL}, _capacity{0}, _size{0} {
-        for(InputIter it = first; it != last; ++it) push_back(*it);
+    Vector(InputIter first, InputIter last): _data{NULL}, _capacity{0}, _size{0} {
+        if constexpr (_HasCategory<InputIter, std::forward_iterator_tag>::value) {
+            // size known up front: one allocation, one memcpy for contiguous trivial ranges
+            _capacity = _size = Distance(first, last);
+            _data = _alloc.allocate(_capacity);
+            UninitializedCopy(first, last, _data, _alloc);
+        }
+        else for(InputIter it = first; it != last; ++it) push_back(*it);
     }
-    // move
-    Vector(Vector&& v): _data{v._data}, _capacity{v._capacity}, _size{v._size} {
+    // move (the allocator follows the buffer it allocated)
+    Vector(Vector&& v): _data{v._data}, _capacity{v._capacity}, _size{v._size}, _alloc{std::move(v._alloc)} {
         v._data = NULL;
         v._capacity = v._size = 0;
     }
 
     ~Vector() {
-        for(int i = _size - 1; i >= 0; --i) _alloc.destroy(_data + i);
+        DestroyN(_data, _size, _alloc);
         _alloc.deallocate(_data, _capacity);
         _data = NULL;
         _capacity = _size = 0;
@@ -88,10 +112,10 @@ public:
     // copy assign
     Vector& operator=(const Vector& v) {
         if(&v != this) {
-            for(int i = _size - 1; i >= 0; --i) _alloc.destroy(_data + i);
+            DestroyN(_data, _size, _alloc);
             _alloc.deallocate(_data, _capacity);
-            _data = _alloc.allocate(v._data, v._size);
-            for(int i = 0; i < v._size; ++i) _alloc.construct(_data + i, v._data[i]);
+            _data = _alloc.allocate(v._size);
+            UninitializedCopy(v.begin(), v.end(), _data, _alloc);
             _capacity = v._size;
             _size = v._size;
         }
@@ -101,8 +125,9 @@ public:
     // move assign
     Vector& operator=(Vector&& v) {
         if(&v != this) {
-            for(int i = _size - 1; i >= 0; --i) _alloc.destroy(_data + i);
+            DestroyN(_data, _size, _alloc);
             _alloc.deallocate(_data, _capacity);
+            _alloc = std::move(v._alloc);
             _data = v._data;
             v._data = NULL;
             _size = v._size;
@@ -119,6 +144,7 @@ public:
     bool empty() const { return _size == 0; }
 
     // data
+    T* data() { return _data; }
     const T* data() const { return _data; }
 
     // access
@@ -130,6 +156,9 @@ public:
         if(index < 0 || index >= _size) throw std::out_of_range("vector index out of range");
         return _data[index];
     }
+    // no range check, for hot loops that already know their bounds
+    T& at_unchecked(const size_t& index) { return _data[index]; }
+    const T& at_unchecked(const size_t& index) const { return _data[index]; }
     // use operator[] to enforce range check
     T& front() { return operator[](0); }
     T& back() { return operator[](_size - 1); }
@@ -170,37 +199,35 @@ public:
         _capacity = size;
         _size = size;
     }
+    // grow capacity ahead of a known number of push_back (never shrinks)
+    void reserve(const size_t& capacity) {
+        if(capacity <= _capacity) return;
+        _resize(_size, _capacity, capacity);
+        _capacity = capacity;
+    }
     // shrink capacity to size
     void shrink() { resize(_size); }
     void clear() { resize(0); }
 
-    // insert
+    // insert, in place (the range must not alias this vector)
     void insert(const Iterator& pos, const size_t& n, const T& item) {
-        Vector tail;
-        for(ReverseIterator it = rbegin(); it != pos; ++it) {
-            tail.push_back(std::move(*it));
-            pop_back();
-        }
-        // insert
-        for(int i = 0; i < n; ++i) push_back(item);
-        // append with move
-        for(ReverseIterator it = tail.rbegin(); it != tail.rend(); ++it) {
-            push_back(std::move(*it));
-            tail.pop_back();
-        }
-    }
-    void insert(const Iterator& pos, const Iterator& first, const Iterator& last) {
-        Vector tail;
-        for(ReverseIterator it = rbegin(); it != pos; ++it) {
-            tail.push_back(std::move(*it));
-            pop_back();
-        }
-        // insert
-        for(auto it = first; it != last; ++it) push_back(*it);
-        // append with move
-        for(ReverseIterator it = tail.rbegin(); it != tail.rend(); ++it) {
-            push_back(std::move(*it));
-            tail.pop_back();
+        size_t at = pos.base() - _data;
+        // item may live in this vector
+        T tmp(item);
+        _open(at, n);
+        UninitializedFill(_data + at, n, tmp, _alloc);
+    }
+    template <class InputIter, typename = std::enable_if_t<_IsIterator<InputIter>::value && !std::is_integral<InputIter>::value>>
+    void insert(const Iterator& pos, InputIter first, InputIter last) {
+        if constexpr (_HasCategory<InputIter, std::forward_iterator_tag>::value) {
+            // size known up front: one opening, one copy
+            size_t at = pos.base() - _data, n = Distance(first, last);
+            _open(at, n);
+            UninitializedCopy(first, last, _data + at, _alloc);
+        } else {
+            // single pass: buffer the items, then move them in as a counted range
+            Vector tmp(first, last);
+            insert(pos, std::make_move_iterator(tmp.begin()), std::make_move_iterator(tmp.end()));
         }
     }
 };
@@ -0,0 +1,74 @@
+// read-only views: a pointer and a length into memory owned by someone else (an archive, a batch buffer),
+// with the read interface of the container they stand in for
+
+#pragma once
+
+#include <cstring>
+#include <stdexcept>
+
+#include "Iterator.h"
+#include "String.h"
+#include "Vector.h"
+
+
+// same read interface as a const Vector
+template <class T>
+class VectorView {
+public:
+    typedef _RandomIterator<const T> ConstIterator;
+
+protected:
+    const T *_data;
+    size_t _size;
+
+public:
+    VectorView(const T* data = NULL, const size_t& size = 0): _data{data}, _size{size} { }
+
+    ConstIterator begin() const { return ConstIterator(_data); }
+    ConstIterator end() const { return ConstIterator(_data + _size); }
+
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+    const T* data() const { return _data; }
+
+    const T& operator[](const size_t& index) const {
+        if(index >= _size) throw std::out_of_range("vector index out of range");
+        return _data[index];
+    }
+    const T& at_unchecked(const size_t& index) const { return _data[index]; }
+    const T& front() const { return operator[](0); }
+    const T& back() const { return operator[](_size - 1); }
+
+    // owned copy, one allocation and one memcpy
+    Vector<T> to_vector() const { return Vector<T>(_data, _data + _size); }
+};
+
+// same read interface as a const String
+class StringView {
+public:
+    typedef _RandomIterator<const char> ConstIterator;
+
+protected:
+    // the owner keeps a terminator after the chars, so c_str() and match() need no copy
+    const char *_data;
+    size_t _len;
+
+public:
+    StringView(const char* data = "", const size_t& len = 0): _data{data}, _len{len} { }
+
+    ConstIterator begin() const { return ConstIterator(_data); }
+    ConstIterator end() const { return ConstIterator(_data + _len); }
+
+    const char* c_str() const { return _data; }
+    size_t length() const { return _len; }
+
+    const char& operator[](const size_t& index) const {
+        if(index >= _len) throw std::out_of_range("string index out of range");
+        return _data[index];
+    }
+
+    String to_string() const { return String(_data); }
+    bool match(const char* regex) const { return match_regex(regex, _data); }
+};
+
+inline bool operator==(const StringView& lhs, const char* rhs) { return strcmp(lhs.c_str(), rhs) == 0; }
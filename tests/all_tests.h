@@ -2,6 +2,23 @@
 
 #pragma once
 
-//#include "string_test.h"
+#include "string_test.h"
 #include "vector_test.h"
-//#include "list_test.h"
+#include "list_test.h"
+#include "allocator_test.h"
+#include "numeric_test.h"
+#include "small_vector_test.h"
+#include "shared_string_test.h"
+#include "flat_map_test.h"
+#include "static_vector_test.h"
+#include "static_string_test.h"
+#include "iterator_test.h"
+#include "deque_test.h"
+#include "priority_queue_test.h"
+#include "archive_test.h"
+#include "charconv_test.h"
+#include "coroutine_test.h"
+#include "pipeline_test.h"
+#include "multi_matcher_test.h"
+#include "perf_test.h"
+#include "sort_test.h"
@@ -0,0 +1,135 @@
+// counting allocator test
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <sstream>
+
+#include "../lib/CountingAllocator.h"
+#include "../lib/List.h"
+#include "../lib/String.h"
+#include "../lib/Vector.h"
+
+
+template <class T> using CVector = Vector<T, _CountingAllocator<T>>;
+typedef _String<char, _CountingAllocator<char>> CString;
+template <class T> using CList = List<T, _CountingAllocator<T>>;
+
+
+TEST(AllocatorTest, Vector) {
+    AllocStats stats("vector");
+    AllocTag tag(stats);
+    CVector<int> v0;
+    EXPECT_EQ(stats.allocations(), 0);
+    // capacity grows 2, 6, 14
+    for(int i = 0; i < 10; ++i) v0.push_back(i);
+    EXPECT_EQ(stats.allocations(), 3);
+    EXPECT_EQ(stats.reallocations(), 2);
+    EXPECT_EQ(stats.deallocations(), 2);
+    EXPECT_EQ(stats.live_bytes(), 14 * sizeof(int));
+    EXPECT_EQ(stats.peak_bytes(), (6 + 14) * sizeof(int));
+    // move allocates nothing
+    CVector<int> v1(std::move(v0));
+    EXPECT_EQ(stats.allocations(), 3);
+    // copy allocates exactly once
+    CVector<int> v2(v1);
+    EXPECT_EQ(stats.allocations(), 4);
+    EXPECT_EQ(stats.reallocations(), 2);
+    v1.clear();
+    v2.clear();
+    EXPECT_EQ(stats.live_bytes(), 0);
+    EXPECT_EQ(stats.allocations(), stats.deallocations());
+}
+
+TEST(AllocatorTest, MovedVectorGrows) {
+    AllocStats stats("moved vector");
+    AllocTag tag(stats);
+    CVector<int> v0;
+    for(int i = 0; i < 10; ++i) v0.push_back(i);
+    EXPECT_EQ(stats.reallocations(), 2);
+    // the moved-to vector owns the buffer, its growth is a reallocation (14 -> 30)
+    CVector<int> v1(std::move(v0));
+    for(int i = 0; i < 10; ++i) v1.push_back(i);
+    EXPECT_EQ(stats.allocations(), 4);
+    EXPECT_EQ(stats.reallocations(), 3);
+    // the moved-from one holds nothing, its next buffer is fresh
+    v0.push_back(0);
+    EXPECT_EQ(stats.allocations(), 5);
+    EXPECT_EQ(stats.reallocations(), 3);
+    // same through move assign (30 -> 62)
+    CVector<int> v2;
+    v2 = std::move(v1);
+    for(int i = 0; i < 20; ++i) v2.push_back(i);
+    EXPECT_EQ(stats.allocations(), 6);
+    EXPECT_EQ(stats.reallocations(), 4);
+}
+
+TEST(AllocatorTest, String) {
+    AllocStats stats("string");
+    {
+        AllocTag tag(stats);
+        CString s0("hello");
+        EXPECT_EQ(stats.allocations(), 1);
+        CString s1(std::move(s0));
+        EXPECT_EQ(stats.allocations(), 1);
+        CString s2(s1);
+        EXPECT_EQ(stats.allocations(), 2);
+        // 6 -> 12
+        s2 += '!';
+        s2 += '!';
+        EXPECT_EQ(stats.allocations(), 3);
+        EXPECT_EQ(stats.reallocations(), 1);
+    }
+    EXPECT_EQ(stats.live_bytes(), 0);
+    EXPECT_EQ(stats.allocations(), stats.deallocations());
+}
+
+TEST(AllocatorTest, List) {
+    AllocStats stats("list");
+    {
+        AllocTag tag(stats);
+        // pseudo head + 5 nodes
+        CList<int> l0(5, 1);
+        EXPECT_EQ(stats.allocations(), 6);
+        EXPECT_EQ(stats.reallocations(), 0);
+        CList<int> l1(l0);
+        EXPECT_EQ(stats.allocations(), 12);
+    }
+    EXPECT_EQ(stats.live_bytes(), 0);
+    EXPECT_EQ(stats.allocations(), stats.deallocations());
+}
+
+TEST(AllocatorTest, Tags) {
+    AllocStats outer("outer"), inner("inner");
+    AllocTag t0(outer);
+    CVector<int> v0(4, 0);
+    {
+        AllocTag t1(inner);
+        CVector<int> v1(8, 0);
+    }
+    CVector<int> v2(2, 0);
+    EXPECT_EQ(outer.allocations(), 2);
+    EXPECT_EQ(inner.allocations(), 1);
+    EXPECT_EQ(inner.live_bytes(), 0);
+    // 16 bytes in [16, 32), 8 bytes in [8, 16)
+    EXPECT_EQ(outer.histogram(4), 1);
+    EXPECT_EQ(outer.histogram(3), 1);
+}
+
+TEST(AllocatorTest, Json) {
+    AllocStats stats("json");
+    AllocTag tag(stats);
+    CVector<char> v0(3, 'a');
+    std::ostringstream os;
+    stats.dump(os);
+    EXPECT_EQ(os.str(), "{\"name\": \"json\", \"allocations\": 1, \"deallocations\": 0, "
+        "\"reallocations\": 0, \"bytes_allocated\": 3, \"live_bytes\": 3, \"peak_bytes\": 3, "
+        "\"histogram\": {\"2\": 1}}");
+}
+
+TEST(AllocatorTest, JsonEscapedName) {
+    AllocStats stats("a \"quoted\" C:\\path\n");
+    std::ostringstream os;
+    stats.dump(os);
+    EXPECT_EQ(os.str().find("{\"name\": \"a \\\"quoted\\\" C:\\\\path\\u000a\", "), 0u);
+}
@@ -0,0 +1,115 @@
+// archive test
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <unistd.h>
+
+#include "../lib/Archive.h"
+
+
+// temporary file, removed with the object
+struct TempFile {
+    char path[32];
+    int fd;
+    TempFile() {
+        strcpy(path, "/tmp/archive_test_XXXXXX");
+        fd = mkstemp(path);
+    }
+    ~TempFile() {
+        close(fd);
+        unlink(path);
+    }
+};
+
+// snapshot test data
+struct Row {
+    int32_t id;
+    double score;
+};
+
+
+TEST(ArchiveTest, RoundTrip) {
+    TempFile f;
+    ASSERT_GE(f.fd, 0);
+    Vector<int> v0({1, 2, 3, 4, 5});
+    Vector<Row> v1({{1, 0.5}, {2, 1.5}});
+    Vector<String> v2({"alpha", "", "gamma"});
+    Vector<Vector<int>> v3({Vector<int>({1}), Vector<int>(), Vector<int>({2, 3})});
+    {
+        ArchiveWriter w(f.fd);
+        w.write(v0).write(char('x')).write(v1).write(String("hello")).write(v2).write(v3);
+        w.flush();
+    }
+    ArchiveReader r(f.path);
+    Vector<int> u0;
+    char c;
+    Vector<Row> u1;
+    String s;
+    Vector<String> u2;
+    Vector<Vector<int>> u3;
+    r.read(u0).read(c).read(u1).read(s).read(u2).read(u3);
+    EXPECT_EQ(r.remaining(), 0);
+    EXPECT_EQ(u0.size(), 5);
+    for(int i = 0; i < 5; ++i) EXPECT_EQ(u0[i], i + 1);
+    EXPECT_EQ(c, 'x');
+    EXPECT_EQ(u1[1].id, 2);
+    EXPECT_EQ(u1[1].score, 1.5);
+    EXPECT_EQ(s, String("hello"));
+    EXPECT_EQ(u2.size(), 3);
+    EXPECT_EQ(u2[0], String("alpha"));
+    EXPECT_EQ(u2[1].length(), 0);
+    EXPECT_EQ(u2[2], String("gamma"));
+    EXPECT_EQ(u3.size(), 3);
+    EXPECT_TRUE(u3[1].empty());
+    EXPECT_EQ(u3[2][1], 3);
+    EXPECT_THROW(r.read<int>(), std::out_of_range);
+}
+
+TEST(ArchiveTest, View) {
+    TempFile f;
+    ASSERT_GE(f.fd, 0);
+    // large payloads bypass the buffer
+    Vector<double> v0(100000, 0.0);
+    for(size_t i = 0; i < v0.size(); ++i) v0.at_unchecked(i) = i * 0.5;
+    {
+        ArchiveWriter w(f.fd);
+        // misalign the stream on purpose, the vector is padded back
+        w.write(char(1)).write(v0).write(String("tail")).write(Vector<Vector<int>>({Vector<int>({7, 8}), Vector<int>({9})}));
+    }
+    ArchiveReader r(f.path);
+    EXPECT_EQ(r.read<char>(), 1);
+    // the views point into the mapped file
+    VectorView<double> d = r.view_vector<double>();
+    EXPECT_EQ(d.size(), 100000);
+    EXPECT_EQ((uintptr_t)d.data() % alignof(double), 0);
+    EXPECT_EQ(d[99999], 99999 * 0.5);
+    EXPECT_THROW(d[100000], std::out_of_range);
+    StringView s = r.view_string();
+    EXPECT_EQ(s.length(), 4);
+    EXPECT_TRUE(s == "tail");
+    EXPECT_TRUE(s.match("^ta.l$"));
+    size_t n = r.read_size();
+    EXPECT_EQ(n, 2);
+    VectorView<int> a = r.view_vector<int>(), b = r.view_vector<int>();
+    EXPECT_EQ(a.back(), 8);
+    EXPECT_EQ(b.front(), 9);
+    EXPECT_EQ(a.to_vector()[0], 7);
+}
+
+TEST(ArchiveTest, Invalid) {
+    char junk[16] = "not an archive";
+    EXPECT_THROW(ArchiveReader(junk, sizeof(junk)), std::invalid_argument);
+    EXPECT_THROW(ArchiveReader("/nonexistent/archive"), std::system_error);
+    // a count larger than the archive is rejected before reading
+    TempFile f;
+    {
+        ArchiveWriter w(f.fd);
+        w.write(uint64_t(1) << 40);
+    }
+    ArchiveReader r(f.path);
+    EXPECT_THROW(r.view_vector<int>(), std::out_of_range);
+}
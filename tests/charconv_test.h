@@ -0,0 +1,102 @@
+// charconv test
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <random>
+
+#include "../lib/Charconv.h"
+#include "../lib/CountingAllocator.h"
+#include "../lib/String.h"
+
+
+TEST(CharconvTest, AppendInt) {
+    String s0("id=");
+    s0.append_int(42).append_int(-7).append_int((unsigned char)255);
+    EXPECT_EQ(s0, String("id=42-7255"));
+    String s1;
+    s1.append_int(INT64_MIN);
+    EXPECT_EQ(s1, String("-9223372036854775808"));
+    String s2;
+    s2.append_int(UINT64_MAX).append_int(0);
+    EXPECT_EQ(s2, String("184467440737095516150"));
+
+    // reserved once, then written in place
+    AllocStats stats("charconv");
+    AllocTag tag(stats);
+    _String<char, _CountingAllocator<char>> s3;
+    s3.reserve(1000);
+    size_t before = stats.allocations();
+    for(int i = 0; i < 100; ++i) s3.append_int(i * 37);
+    EXPECT_EQ(stats.allocations(), before);
+}
+
+TEST(CharconvTest, AppendDouble) {
+    double values[] = {0.0, -0.0, 1.0, 0.1, 0.3, 1.5e-7, 100.0, 1e21, 1e22, 1e23, 123456.789,
+                       5e-324, 2.2250738585072014e-308, 1.7976931348623157e308, 9007199254740993.0};
+    const char* expect[] = {"0", "-0", "1", "0.1", "0.3", "1.5e-07", "100", "1e+21", "1e+22", "1e+23", "123456.789",
+                            "5e-324", "2.2250738585072014e-308", "1.7976931348623157e+308", "9007199254740992"};
+    for(int i = 0; i < 15; ++i) {
+        String s;
+        s.append_double(values[i]);
+        EXPECT_EQ(s, String(expect[i]));
+    }
+    String s;
+    s.append_double(INFINITY).append_double(-INFINITY);
+    EXPECT_EQ(s, String("inf-inf"));
+
+    // same text as std::to_chars, and it reads back to the same bits
+    std::mt19937_64 gen(7);
+    char a[DOUBLE_CHARS_MAX], b[DOUBLE_CHARS_MAX];
+    for(int i = 0; i < 100000; ++i) {
+        uint64_t bits = gen();
+        double d;
+        memcpy(&d, &bits, sizeof(d));
+        if(!std::isfinite(d)) continue;
+        char *end = ToChars(a, d);
+        std::to_chars_result r = std::to_chars(b, b + sizeof(b), d);
+        ASSERT_EQ(end - a, r.ptr - b);
+        ASSERT_EQ(memcmp(a, b, end - a), 0);
+        double back;
+        ASSERT_EQ(ParseDouble(a, end, back), end);
+        ASSERT_EQ(memcmp(&back, &d, sizeof(d)), 0);
+    }
+}
+
+TEST(CharconvTest, Parse) {
+    EXPECT_EQ(String("-123").parse_int(), -123);
+    EXPECT_EQ(String("+7").parse_int<unsigned>(), 7);
+    EXPECT_EQ(String("-9223372036854775808").parse_int(), INT64_MIN);
+    EXPECT_THROW(String("9223372036854775808").parse_int(), std::out_of_range);
+    EXPECT_THROW(String("300").parse_int<uint8_t>(), std::out_of_range);
+    EXPECT_THROW(String("-1").parse_int<unsigned>(), std::invalid_argument);
+    EXPECT_THROW(String("12x").parse_int(), std::invalid_argument);
+    EXPECT_THROW(String("").parse_int(), std::invalid_argument);
+
+    EXPECT_EQ(String("0.1").parse_double(), 0.1);
+    EXPECT_EQ(String("-2.5e3").parse_double(), -2500.0);
+    EXPECT_EQ(String(".5").parse_double(), 0.5);
+    EXPECT_EQ(String("1e-400").parse_double(), 0.0);
+    // long inputs take the exact slow path
+    EXPECT_EQ(String("3.14159265358979323846264338327950288").parse_double(), 3.141592653589793);
+    EXPECT_EQ(String("1.7976931348623157e308").parse_double(), 1.7976931348623157e308);
+    EXPECT_THROW(String("1e400").parse_double(), std::out_of_range);
+    EXPECT_THROW(String("e5").parse_double(), std::invalid_argument);
+    EXPECT_TRUE(std::isinf(String("-inf").parse_double()));
+
+    // tokenizing with pos
+    String s("12,3.5,-4");
+    size_t pos = 0;
+    EXPECT_EQ(s.parse_int(&pos), 12);
+    EXPECT_EQ(pos, 2);
+    ++pos;
+    EXPECT_EQ(s.parse_double(&pos), 3.5);
+    ++pos;
+    EXPECT_EQ(s.parse_int(&pos), -4);
+    EXPECT_EQ(pos, s.length());
+}
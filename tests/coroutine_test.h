@@ -0,0 +1,146 @@
+// coroutine test
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <exception>
+#include <thread>
+
+#include "../lib/Coroutine.h"
+
+
+Generator<int> Fibonacci(int n) {
+    int a = 0, b = 1;
+    for(int i = 0; i < n; ++i) {
+        co_yield a;
+        b = a + b;
+        a = b - a;
+    }
+}
+
+Generator<int> Failing() {
+    co_yield 1;
+    throw std::runtime_error("generator failed");
+}
+
+Task<int> Square(int x) { co_return x * x; }
+
+Task<int> SumOfSquares(int n) {
+    int sum = 0;
+    for(int i = 1; i <= n; ++i) sum += co_await Square(i);
+    co_return sum;
+}
+
+Task<void> Store(int n, std::atomic<int>& out) { out += co_await SumOfSquares(n); }
+
+Task<void> Throwing() {
+    co_await Square(1);
+    throw std::invalid_argument("task failed");
+}
+
+
+TEST(CoroutineTest, Generator) {
+    int arr[] = {0, 1, 1, 2, 3, 5, 8, 13};
+    int i = 0;
+    for(int x : Fibonacci(8)) EXPECT_EQ(x, arr[i++]);
+    EXPECT_EQ(i, 8);
+    Generator<int> g = Failing();
+    Generator<int>::Iterator it = g.begin();
+    EXPECT_EQ(*it, 1);
+    EXPECT_THROW(++it, std::runtime_error);
+}
+
+TEST(CoroutineTest, Task) {
+    ThreadPool pool(4);
+    std::atomic<int> sum(0);
+    for(int i = 0; i < 100; ++i) pool.spawn(Store(10, sum));
+    pool.wait();
+    EXPECT_EQ(sum.load(), 100 * 385);
+    // the first exception comes out of wait
+    pool.spawn(Throwing());
+    EXPECT_THROW(pool.wait(), std::invalid_argument);
+    pool.wait();
+}
+
+
+Task<void> Produce(Channel<int>& ch, int first, int n, std::atomic<int>& max_buffered, std::atomic<int>& in_flight) {
+    for(int i = first; i < first + n; ++i) {
+        int now = ++in_flight;
+        if(now > max_buffered) max_buffered = now;
+        if(!co_await ch.send(i)) break;
+    }
+    ch.close();
+}
+
+Task<void> Consume(ThreadPool& pool, Channel<int>& ch, std::atomic<long>& sum, std::atomic<int>& count, std::atomic<int>& in_flight) {
+    int x;
+    while(co_await ch.receive(x)) {
+        --in_flight;
+        sum += x;
+        ++count;
+        // let the producers run into a full channel
+        co_await pool.schedule();
+    }
+}
+
+TEST(CoroutineTest, Channel) {
+    for(size_t capacity : {0, 1, 16}) {
+        ThreadPool pool(4);
+        Channel<int> ch(pool, capacity, 3);
+        std::atomic<long> sum(0);
+        std::atomic<int> count(0), max_buffered(0), in_flight(0);
+        for(int p = 0; p < 3; ++p) pool.spawn(Produce(ch, p * 1000, 1000, max_buffered, in_flight));
+        for(int c = 0; c < 2; ++c) pool.spawn(Consume(pool, ch, sum, count, in_flight));
+        pool.wait();
+        EXPECT_EQ(count.load(), 3000);
+        EXPECT_EQ(sum.load(), 2999L * 3000 / 2);
+        // backpressure: at most one pending send per producer beyond the buffer (and one per consumer in hand)
+        EXPECT_LE(max_buffered.load(), (int)capacity + 3 + 2);
+    }
+}
+
+TEST(CoroutineTest, ChannelClosed) {
+    ThreadPool pool(2);
+    Channel<int> ch(pool, 1);
+    std::atomic<long> sum(0);
+    std::atomic<int> count(0), in_flight(0);
+    ch.close();
+    pool.spawn(Consume(pool, ch, sum, count, in_flight));
+    pool.wait();
+    EXPECT_EQ(count.load(), 0);
+}
+
+Task<void> ProduceUntilCancelled(Channel<int>& ch, std::atomic<int>& sent) {
+    for(int i = 0; i < 1000; ++i) {
+        if(!co_await ch.send(i)) break;
+        ++sent;
+    }
+    ch.close();
+}
+
+Task<void> ConsumeThenCancel(Channel<int>& ch, const int n) {
+    int x;
+    for(int i = 0; i < n && co_await ch.receive(x); ++i) { }
+    ch.cancel();
+}
+
+TEST(CoroutineTest, ChannelCancelled) {
+    ThreadPool pool(2);
+    Channel<int> ch(pool, 4);
+    std::atomic<int> sent(0);
+    // the producer blocks on the full channel until the consumer gives up
+    pool.spawn(ProduceUntilCancelled(ch, sent));
+    pool.spawn(ConsumeThenCancel(ch, 10));
+    pool.wait();
+    EXPECT_GE(sent.load(), 10);
+    EXPECT_LE(sent.load(), 10 + 4 + 1);
+
+    // later sends fail and receives see the channel drained
+    std::atomic<long> sum(0);
+    std::atomic<int> count(0), in_flight(0);
+    pool.spawn(ProduceUntilCancelled(ch, sent));
+    pool.spawn(Consume(pool, ch, sum, count, in_flight));
+    pool.wait();
+    EXPECT_EQ(count.load(), 0);
+}
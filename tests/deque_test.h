@@ -0,0 +1,112 @@
+// deque test
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <exception>
+
+#include "../lib/CountingAllocator.h"
+#include "../lib/Deque.h"
+#include "../lib/String.h"
+
+
+template <class T> using CDeque = Deque<T, _CountingAllocator<T>>;
+
+
+TEST(DequeTest, BothEnds) {
+    Deque<int> d0;
+    EXPECT_TRUE(d0.empty());
+    EXPECT_THROW(d0.pop_front(), std::underflow_error);
+    EXPECT_THROW(d0.pop_back(), std::underflow_error);
+    for(int i = 0; i < 5; ++i) {
+        d0.push_back(i);
+        d0.push_front(-i - 1);
+    }
+    int arr[] = {-5, -4, -3, -2, -1, 0, 1, 2, 3, 4};
+    EXPECT_EQ(d0.size(), 10);
+    for(int i = 0; i < 10; ++i) EXPECT_EQ(d0[i], arr[i]);
+    EXPECT_THROW(d0[10], std::out_of_range);
+    d0.pop_front();
+    d0.pop_back();
+    EXPECT_EQ(d0.front(), -4);
+    EXPECT_EQ(d0.back(), 3);
+    // copies are independent
+    Deque<int> d1(d0);
+    d1.front() = 100;
+    EXPECT_EQ(d0.front(), -4);
+    Deque<int> d2(std::move(d1));
+    EXPECT_TRUE(d1.empty());
+    EXPECT_EQ(d2.front(), 100);
+}
+
+TEST(DequeTest, Wrap) {
+    AllocStats stats("deque");
+    AllocTag tag(stats);
+    // a sliding window never reallocates once the buffer holds it
+    CDeque<int> d0;
+    for(int i = 0; i < 8; ++i) d0.push_back(i);
+    for(int i = 8; i < 1000; ++i) {
+        d0.pop_front();
+        d0.push_back(i);
+        EXPECT_EQ(d0.front(), i - 7);
+    }
+    EXPECT_EQ(stats.allocations(), 1);
+    EXPECT_EQ(d0.capacity(), 8);
+    // growing while wrapped keeps the order, capacity stays a power of two
+    d0.push_front(-1);
+    EXPECT_EQ(d0.capacity(), 16);
+    EXPECT_EQ(d0[0], -1);
+    for(size_t i = 1; i < d0.size(); ++i) EXPECT_EQ(d0[i], 992 + (int)i - 1);
+    d0.clear();
+    EXPECT_EQ(d0.size(), 0);
+    EXPECT_EQ(stats.allocations(), 2);
+}
+
+TEST(DequeTest, Bulk) {
+    Deque<int> d0;
+    int arr[20];
+    for(int i = 0; i < 20; ++i) arr[i] = i;
+    d0.push_back_n(arr, 6);
+    d0.pop_front_n(4);
+    // the next 10 items wrap around the end of the buffer
+    d0.push_back_n(arr + 6, 10);
+    EXPECT_EQ(d0.size(), 12);
+    for(int i = 0; i < 12; ++i) EXPECT_EQ(d0[i], i + 4);
+    int out[12];
+    d0.pop_front_n(out, 7);
+    for(int i = 0; i < 7; ++i) EXPECT_EQ(out[i], i + 4);
+    EXPECT_EQ(d0.front(), 11);
+    EXPECT_THROW(d0.pop_front_n(6), std::underflow_error);
+
+    // non trivial items are moved out
+    Deque<String> d1;
+    String s[3] = {"a", "bb", "ccc"};
+    d1.push_back_n(s, 3);
+    d1.pop_front_n(1);
+    d1.push_back(String("dddd"));
+    EXPECT_EQ(d1.size(), 3);
+    EXPECT_EQ(d1.back(), String("dddd"));
+    EXPECT_EQ(s[0], String("a"));
+}
+
+TEST(DequeTest, Iterator) {
+    Deque<int> d0;
+    for(int i = 0; i < 6; ++i) d0.push_back(i);
+    d0.pop_front_n(3);
+    for(int i = 6; i < 10; ++i) d0.push_back(9 - i + 6);
+    // 3 4 5 9 8 7 6, wrapped in a buffer of 8
+    EXPECT_EQ(d0.end() - d0.begin(), 7);
+    EXPECT_EQ(*(d0.begin() + 3), 9);
+    EXPECT_EQ(d0.begin()[6], 6);
+    EXPECT_EQ(*(d0.end() - 1), 6);
+    EXPECT_TRUE(d0.begin() < d0.end());
+    std::sort(d0.begin(), d0.end());
+    int arr[] = {3, 4, 5, 6, 7, 8, 9};
+    const Deque<int>& c0 = d0;
+    int i = 0;
+    for(Deque<int>::ConstIterator it = c0.begin(); it != c0.end(); ++it) EXPECT_EQ(*it, arr[i++]);
+    Sort(d0.begin(), d0.end(), [](int a, int b) { return a > b; });
+    EXPECT_EQ(d0.front(), 9);
+    EXPECT_EQ(d0.back(), 3);
+}
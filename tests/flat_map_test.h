@@ -0,0 +1,72 @@
+// flat map test
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <exception>
+
+#include "../lib/FlatMap.h"
+
+
+TEST(FlatMapTest, Sort) {
+    // long enough to partition, with duplicates and reversed runs
+    Vector<int> v0;
+    for(int i = 0; i < 200; ++i) v0.push_back((i * 37) % 101);
+    Sort(v0.begin(), v0.end());
+    for(int i = 1; i < 200; ++i) EXPECT_LE(v0[i - 1], v0[i]);
+    int arr[] = {5, 4, 3, 2, 1};
+    Sort(arr, arr + 5, [](const int& a, const int& b) { return b < a; });
+    EXPECT_EQ(arr[0], 5);
+    EXPECT_EQ(arr[4], 1);
+}
+
+TEST(FlatMapTest, Set) {
+    FlatSet<int> s0({7, 3, 9, 3, 1, 7, 5});
+    int arr[] = {1, 3, 5, 7, 9};
+    EXPECT_EQ(s0.size(), 5);
+    for(int i = 0; i < 5; ++i) EXPECT_EQ(s0.keys()[i], arr[i]);
+    for(int k = 0; k <= 10; ++k) EXPECT_EQ(s0.contains(k), k % 2 == 1 && k < 10);
+    EXPECT_EQ(s0.index_of(7), 3);
+    EXPECT_EQ(s0.index_of(8), FlatSet<int>::npos);
+    EXPECT_TRUE(s0.insert(4));
+    EXPECT_FALSE(s0.insert(4));
+    EXPECT_EQ(s0.index_of(5), 3);
+    FlatSet<int> s1;
+    EXPECT_FALSE(s1.contains(0));
+}
+
+TEST(FlatMapTest, Map) {
+    FlatMap<int, char> m0({{3, 'c'}, {1, 'a'}, {2, 'b'}, {1, 'z'}});
+    EXPECT_EQ(m0.size(), 3);
+    // first duplicate wins
+    EXPECT_EQ(m0.at(1), 'a');
+    EXPECT_EQ(*m0.find(3), 'c');
+    EXPECT_EQ(m0.find(4), (char*)NULL);
+    EXPECT_THROW(m0.at(4), std::out_of_range);
+    EXPECT_TRUE(m0.insert(0, 'o'));
+    EXPECT_EQ(m0.values()[0], 'o');
+    *m0.find(2) = 'B';
+    EXPECT_EQ(m0.at(2), 'B');
+    EXPECT_THROW((FlatMap<int, int>(Vector<int>(2, 0), Vector<int>(1, 0))), std::invalid_argument);
+}
+
+TEST(FlatMapTest, LookupMany) {
+    Vector<int> keys, values, queries;
+    for(int i = 0; i < 1000; ++i) {
+        keys.push_back(3 * i);
+        values.push_back(i);
+    }
+    for(int i = 0; i < 101; ++i) queries.push_back(7 * i);
+    FlatMap<int, int> m0(std::move(keys), std::move(values));
+    Vector<const int*> out;
+    m0.lookup_many(queries, out);
+    ASSERT_EQ(out.size(), 101);
+    for(int i = 0; i < 101; ++i) {
+        if((7 * i) % 3 == 0) EXPECT_EQ(*out[i], 7 * i / 3);
+        else EXPECT_EQ(out[i], (const int*)NULL);
+    }
+    FlatSet<int> s0(m0.keys());
+    Vector<bool> found;
+    s0.lookup_many(queries, found);
+    for(int i = 0; i < 101; ++i) EXPECT_EQ(found[i], (7 * i) % 3 == 0);
+}
@@ -0,0 +1,80 @@
+// iterator test
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <type_traits>
+
+#include "../lib/String.h"
+#include "../lib/Vector.h"
+
+
+TEST(IteratorTest, Traits) {
+    typedef Vector<int>::Iterator It;
+    typedef Vector<int>::ConstReverseIterator CRIt;
+    static_assert(std::is_same<std::iterator_traits<It>::iterator_category, std::random_access_iterator_tag>::value, "category");
+    static_assert(std::is_same<std::iterator_traits<It>::value_type, int>::value, "value type");
+    static_assert(std::is_same<std::iterator_traits<CRIt>::value_type, int>::value, "const value type");
+    static_assert(std::is_same<std::iterator_traits<CRIt>::reference, const int&>::value, "const reference");
+    static_assert(std::is_same<std::iterator_traits<It>::difference_type, std::ptrdiff_t>::value, "difference type");
+    static_assert(_IsContiguous<It>::value && _IsContiguous<int*>::value, "contiguous");
+    static_assert(!_IsContiguous<CRIt>::value, "reverse is not contiguous");
+    static_assert(_IsIterator<It>::value && !_IsIterator<int>::value, "iterator");
+}
+
+TEST(IteratorTest, Const) {
+    Vector<int> v0({1, 2, 3, 4});
+    // const iterators, arithmetic on const objects
+    const Vector<int>::Iterator it = v0.begin();
+    EXPECT_EQ(*(it + 3), 4);
+    EXPECT_EQ(it[2], 3);
+    EXPECT_EQ(*(2 + it), 3);
+    Vector<int>::ConstIterator cit = it;
+    EXPECT_EQ(*cit, 1);
+    EXPECT_TRUE(it < it + 1);
+    EXPECT_TRUE(it + 1 >= it);
+    // reverse iterators order backwards
+    Vector<int>::ReverseIterator rit = v0.rbegin();
+    EXPECT_EQ(rit[0], 4);
+    EXPECT_EQ(rit[3], 1);
+    EXPECT_TRUE(rit < rit + 1);
+    EXPECT_EQ(v0.rend() - v0.rbegin(), 4);
+}
+
+TEST(IteratorTest, StdAlgorithms) {
+    Vector<int> v0({5, 2, 8, 1, 9, 3});
+    std::sort(v0.begin(), v0.end());
+    int arr[] = {1, 2, 3, 5, 8, 9};
+    for(int i = 0; i < 6; ++i) EXPECT_EQ(v0[i], arr[i]);
+    EXPECT_EQ(std::accumulate(v0.begin(), v0.end(), 0), 28);
+    EXPECT_TRUE(std::binary_search(v0.begin(), v0.end(), 8));
+    std::sort(v0.rbegin(), v0.rend());
+    EXPECT_EQ(v0[0], 9);
+    EXPECT_EQ(std::distance(v0.begin(), v0.end()), 6);
+    String s0("dcba");
+    std::reverse(s0.begin(), s0.end());
+    EXPECT_TRUE(s0 == "abcd");
+}
+
+TEST(IteratorTest, BulkPaths) {
+    // pointers and reverse iterators construct and insert too
+    int arr[] = {1, 2, 3};
+    Vector<int> v0(arr, arr + 3);
+    EXPECT_EQ(v0.capacity(), 3);
+    Vector<int> v1(v0.rbegin(), v0.rend());
+    EXPECT_EQ(v1[0], 3);
+    v1.insert(v1.begin() + 1, arr, arr + 3);
+    int arr2[] = {3, 1, 2, 3, 2, 1};
+    for(int i = 0; i < 6; ++i) EXPECT_EQ(v1[i], arr2[i]);
+    // non-trivial types still go through their constructors
+    Vector<String> v2;
+    v2.push_back(String("a"));
+    v2.push_back(String("b"));
+    Vector<String> v3(v2);
+    v3.insert(v3.begin(), v2.begin(), v2.end());
+    EXPECT_TRUE(v3[0] == "a" && v3[1] == "b" && v3[2] == "a" && v3[3] == "b");
+    EXPECT_NE(v3[0].c_str(), v2[0].c_str());
+}
@@ -0,0 +1,110 @@
+// multi matcher test
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "../lib/MultiMatcher.h"
+#include "../lib/String.h"
+#include "../lib/Vector.h"
+
+
+// every occurrence of every pattern by brute force, sorted
+inline std::vector<std::pair<size_t, size_t>> NaiveMatches(const Vector<String>& patterns, const String& text) {
+    std::vector<std::pair<size_t, size_t>> ret;
+    for(size_t i = 0; i < patterns.size(); ++i) {
+        const String& p = patterns.at_unchecked(i);
+        for(size_t j = 0; j + p.length() <= text.length(); ++j) {
+            if(memcmp(text.c_str() + j, p.c_str(), p.length()) == 0) ret.push_back({i, j});
+        }
+    }
+    std::sort(ret.begin(), ret.end());
+    return ret;
+}
+
+inline std::vector<std::pair<size_t, size_t>> SortedMatches(const Vector<MultiMatch>& hits) {
+    std::vector<std::pair<size_t, size_t>> ret;
+    for(const MultiMatch& m : hits) ret.push_back({m.pattern, m.position});
+    std::sort(ret.begin(), ret.end());
+    return ret;
+}
+
+TEST(MultiMatcherTest, Overlapping) {
+    MultiMatcher m({"he", "she", "his", "hers"});
+    EXPECT_EQ(m.size(), 4);
+    Vector<MultiMatch> hits = m.find_all(String("ushers"));
+    // ordered by end, longest first at the same end
+    Vector<MultiMatch> expected = {{1, 1}, {0, 2}, {3, 2}};
+    ASSERT_EQ(hits.size(), expected.size());
+    for(size_t i = 0; i < hits.size(); ++i) EXPECT_EQ(hits[i], expected[i]);
+
+    EXPECT_TRUE(m.contains(String("a hiss")));
+    EXPECT_FALSE(m.contains(String("no match")));
+    EXPECT_FALSE(m.contains(String("")));
+}
+
+TEST(MultiMatcherTest, Duplicates) {
+    MultiMatcher m({"ab", "b", "ab"});
+    Vector<MultiMatch> hits = m.find_all("xab", 3);
+    Vector<MultiMatch> expected = {{0, 1}, {2, 1}, {1, 2}};
+    ASSERT_EQ(hits.size(), expected.size());
+    for(size_t i = 0; i < hits.size(); ++i) EXPECT_EQ(hits[i], expected[i]);
+
+    EXPECT_THROW(MultiMatcher({"a", ""}), std::invalid_argument);
+    MultiMatcher none({});
+    EXPECT_FALSE(none.contains(String("anything")));
+}
+
+TEST(MultiMatcherTest, RawBuffer) {
+    // bytes past n are not read, embedded '\0' and high bytes are ordinary bytes
+    const char data[] = "ab\0\xff" "ab|ab";
+    Vector<String> patterns = {String("b"), String("\xff" "a")};
+    MultiMatcher m(patterns);
+    EXPECT_EQ(m.find_all(data, 6).size(), 3);
+    EXPECT_EQ(m.find_all(data, sizeof(data) - 1).size(), 4);
+
+    size_t count = 0;
+    m.scan(StringView(data + 3, 3), [&count](const size_t& pattern, const size_t& position) {
+        EXPECT_EQ(pattern, count == 0 ? 1 : 0);
+        EXPECT_EQ(position, count == 0 ? 0 : 2);
+        ++count;
+    });
+    EXPECT_EQ(count, 2);
+}
+
+TEST(MultiMatcherTest, SingleStartByte) {
+    // every pattern starts with '[', the scan jumps between them with memchr
+    MultiMatcher m({"[ERROR]", "[WARN]", "[E"});
+    String line("12:00 [INFO] ok [WARN] disk [ERROR] full [E");
+    Vector<MultiMatch> hits = m.find_all(line);
+    Vector<MultiMatch> expected = {{1, 16}, {2, 28}, {0, 28}, {2, 41}};
+    ASSERT_EQ(hits.size(), expected.size());
+    for(size_t i = 0; i < hits.size(); ++i) EXPECT_EQ(hits[i], expected[i]);
+}
+
+TEST(MultiMatcherTest, Random) {
+    std::mt19937 gen(7);
+    // a small alphabet makes overlaps and shared prefixes common
+    for(int round = 0; round < 50; ++round) {
+        Vector<String> patterns;
+        size_t count = 1 + gen() % 40;
+        for(size_t i = 0; i < count; ++i) {
+            String p;
+            size_t len = 1 + gen() % 6;
+            for(size_t j = 0; j < len; ++j) p += (char)('a' + gen() % 3);
+            patterns.push_back(p);
+        }
+        String text;
+        for(size_t j = 0; j < 500; ++j) text += (char)('a' + gen() % 4);
+
+        MultiMatcher m(patterns);
+        std::vector<std::pair<size_t, size_t>> expected = NaiveMatches(patterns, text);
+        EXPECT_EQ(SortedMatches(m.find_all(text)), expected);
+        EXPECT_EQ(m.contains(text), !expected.empty());
+    }
+}
@@ -0,0 +1,78 @@
+// numeric test
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <exception>
+
+#include "../lib/Numeric.h"
+
+
+// values small enough that every summation order is exact
+template <class T>
+Vector<T> iota(const int& n, const int& start = 0) {
+    Vector<T> v;
+    for(int i = 0; i < n; ++i) v.push_back((T)(start + i));
+    return v;
+}
+
+template <class T>
+void reductions() {
+    // sizes around the lane widths exercise the scalar tails
+    for(int n = 1; n < 40; ++n) {
+        Vector<T> v = iota<T>(n, 1);
+        EXPECT_EQ(Sum(v), (T)(n * (n + 1) / 2));
+        EXPECT_EQ(MinValue(v), (T)1);
+        EXPECT_EQ(MaxValue(v), (T)n);
+        EXPECT_EQ(Dot(v, v), (T)(n * (n + 1) * (2 * n + 1) / 6));
+    }
+    Vector<T> v = iota<T>(17);
+    v[9] = -5;
+    v[16] = 100;
+    EXPECT_EQ(MinValue(v), (T)-5);
+    EXPECT_EQ(MaxValue(v), (T)100);
+}
+
+template <class T>
+void transforms() {
+    for(int n = 1; n < 40; ++n) {
+        Vector<T> x = iota<T>(n), y = iota<T>(n, 1);
+        Axpy(y, (T)2, x);
+        for(int i = 0; i < n; ++i) EXPECT_EQ(y.at_unchecked(i), (T)(3 * i + 1));
+        Add(y, x);
+        for(int i = 0; i < n; ++i) EXPECT_EQ(y.at_unchecked(i), (T)(4 * i + 1));
+        Mul(y, x);
+        for(int i = 0; i < n; ++i) EXPECT_EQ(y.at_unchecked(i), (T)((4 * i + 1) * i));
+    }
+}
+
+
+TEST(NumericTest, Reductions) {
+    reductions<float>();
+    reductions<double>();
+    reductions<int>();
+    reductions<long long>();
+}
+
+TEST(NumericTest, Transforms) {
+    transforms<float>();
+    transforms<double>();
+    transforms<int>();
+    transforms<short>();
+}
+
+TEST(NumericTest, Scan) {
+    Vector<int> v({1, 2, 3, 4, 5});
+    PrefixSum(v);
+    int arr[] = {1, 3, 6, 10, 15};
+    for(int i = 0; i < 5; ++i) EXPECT_EQ(v[i], arr[i]);
+    EXPECT_EQ(CountIf(v, [](const int& x) { return x % 2 == 0; }), 2);
+}
+
+TEST(NumericTest, Exceptions) {
+    Vector<double> v0, v1(3, 1.0);
+    EXPECT_EQ(Sum(v0), 0.0);
+    EXPECT_THROW(MinValue(v0), std::out_of_range);
+    EXPECT_THROW(Dot(v0, v1), std::invalid_argument);
+    EXPECT_THROW(Add(v0, v1), std::invalid_argument);
+}
@@ -0,0 +1,72 @@
+// perf probe test (built with and without -DPERF_PROBES=ON)
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+#include "../lib/Perf.h"
+#include "../lib/String.h"
+#include "../lib/Vector.h"
+
+
+inline void PerfWorkload() {
+    Vector<int> v;
+    for(int i = 0; i < 1000; ++i) v.push_back(i);
+    String s;
+    for(int i = 0; i < 100; ++i) s += 'x';
+    s += String("yz");
+    EXPECT_TRUE(s.match("^x*yz$"));
+}
+
+TEST(PerfTest, Probes) {
+    PerfReset();
+    PerfWorkload();
+    PerfTotals resize = PerfTotalsOf("Vector::_resize");
+    PerfTotals append = PerfTotalsOf("String::operator+=");
+    PerfTotals regex = PerfTotalsOf("match_regex");
+#ifdef PERF_PROBES
+    // growth is geometric
+    EXPECT_GT(resize.calls, 0);
+    EXPECT_LT(resize.calls, 100);
+    EXPECT_EQ(append.calls, 101);
+    EXPECT_EQ(regex.calls, 1);
+    EXPECT_GT(append.cycles, 0);
+    EXPECT_EQ(PerfTotalsOf("never probed").calls, 0);
+
+    PerfReset();
+    EXPECT_EQ(PerfTotalsOf("Vector::_resize").calls, 0);
+#else
+    // compiled out
+    EXPECT_EQ(resize.calls, 0);
+    EXPECT_EQ(append.calls, 0);
+    EXPECT_EQ(regex.calls, 0);
+#endif
+}
+
+TEST(PerfTest, ThreadsAndDump) {
+    PerfReset();
+    // a thread's totals are merged when it exits
+    std::thread t0(PerfWorkload), t1(PerfWorkload);
+    t0.join();
+    t1.join();
+
+    FILE *out = tmpfile();
+    ASSERT_NE(out, (FILE*)NULL);
+    PerfDump(out);
+    char text[4096] = {};
+    rewind(out);
+    size_t n = fread(text, 1, sizeof(text) - 1, out);
+    fclose(out);
+#ifdef PERF_PROBES
+    EXPECT_EQ(PerfTotalsOf("String::operator+=").calls, 202);
+    EXPECT_EQ(PerfTotalsOf("match_regex").calls, 2);
+    EXPECT_NE(strstr(text, "Vector::_resize"), (char*)NULL);
+    EXPECT_NE(strstr(text, "match_regex"), (char*)NULL);
+#else
+    EXPECT_EQ(n, 0);
+#endif
+    (void)n;
+}
@@ -0,0 +1,157 @@
+// pipeline test
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <unistd.h>
+
+#include "../lib/Pipeline.h"
+
+
+// file with the given content, removed with the object
+struct PipelineFile {
+    char path[32];
+    int fd;
+    PipelineFile(const char* content) {
+        strcpy(path, "/tmp/pipeline_test_XXXXXX");
+        fd = mkstemp(path);
+        _WriteAll(fd, content, strlen(content));
+        lseek(fd, 0, SEEK_SET);
+    }
+    ~PipelineFile() {
+        close(fd);
+        unlink(path);
+    }
+    String read_all() {
+        String ret;
+        char buf[256];
+        ssize_t n;
+        lseek(fd, 0, SEEK_SET);
+        while((n = read(fd, buf, sizeof(buf))) > 0) {
+            for(ssize_t i = 0; i < n; ++i) ret += buf[i];
+        }
+        return ret;
+    }
+};
+
+
+// "ERROR 12" -> "12\n"
+struct PipelineNumber {
+    void operator()(const StringView& line, String& text) const {
+        text += String(line.c_str() + 6);
+        text += '\n';
+    }
+};
+
+
+// fails on the n-th line
+struct PipelineFailing {
+    std::atomic<int> lines;
+    int n;
+    explicit PipelineFailing(const int& fail_at): lines{0}, n{fail_at} { }
+    void operator()(const StringView& line, String& text) {
+        if(++lines == n) throw std::runtime_error("transform failed");
+        text += String(line.c_str());
+        text += '\n';
+    }
+};
+
+inline String PipelineInput(const int& lines) {
+    String input;
+    for(int i = 0; i < lines; ++i) {
+        input += String("ERROR ");
+        input.append_int(i);
+        input += '\n';
+    }
+    return input;
+}
+
+
+TEST(PipelineTest, SplitLines) {
+    char text[] = "a\nbb\n\nccc";
+    const char* expect[] = {"a", "bb", "", "ccc"};
+    int i = 0;
+    for(const StringView& line : SplitLines(text, strlen(text))) EXPECT_TRUE(line == expect[i++]);
+    EXPECT_EQ(i, 4);
+}
+
+TEST(PipelineTest, ReadFilterTransformWrite) {
+    // lines longer and shorter than a chunk, no '\n' at the end
+    String input;
+    long expect = 0;
+    for(int i = 0; i < 5000; ++i) {
+        if(i % 1000 == 0) {
+            input += String("info ");
+            for(int j = 0; j < 100; ++j) input += 'x';
+            input += '\n';
+        }
+        input += String(i % 3 == 0 ? "ERROR " : "info ");
+        input.append_int(i);
+        if(i % 3 == 0) expect += i;
+        if(i != 4999) input += '\n';
+    }
+    PipelineFile in(input.c_str()), out("");
+    const size_t workers = 3;
+    ThreadPool pool(4);
+    Channel<LineBatch> raw(pool, 2), kept(pool, 2, workers);
+    Channel<String> text(pool, 2, workers);
+    PipelineNumber number;
+    pool.spawn(ReadLines(in.fd, raw, 64));
+    for(size_t i = 0; i < workers; ++i) {
+        pool.spawn(FilterLines(raw, kept, "^ERROR"));
+        pool.spawn(TransformLines(kept, text, number));
+    }
+    pool.spawn(WriteLines(text, out.fd));
+    pool.wait();
+
+    // batches may arrive in any order, so compare the sum
+    String result = out.read_all();
+    long sum = 0;
+    size_t lines = 0;
+    for(size_t pos = 0; pos < result.length(); ++pos, ++lines) {
+        sum += result.parse_int(&pos);
+        EXPECT_EQ(result[pos], '\n');
+    }
+    EXPECT_EQ(lines, 1667);
+    EXPECT_EQ(sum, expect);
+}
+
+TEST(PipelineTest, StageFails) {
+    // far more input than the channels hold, so every stage is blocked somewhere when the failure hits
+    String input = PipelineInput(20000);
+    PipelineFile in(input.c_str()), out("");
+    const size_t workers = 2;
+    {
+        ThreadPool pool(3);
+        Channel<LineBatch> raw(pool, 1), kept(pool, 1, workers);
+        Channel<String> text(pool, 1, workers);
+        PipelineFailing failing(100);
+        pool.spawn(ReadLines(in.fd, raw, 64));
+        for(size_t i = 0; i < workers; ++i) {
+            pool.spawn(FilterLines(raw, kept, "^ERROR"));
+            pool.spawn(TransformLines(kept, text, failing));
+        }
+        pool.spawn(WriteLines(text, out.fd));
+        EXPECT_THROW(pool.wait(), std::runtime_error);
+    }
+    {
+        // the writer fails: its input is cancelled and the senders upstream are released
+        lseek(in.fd, 0, SEEK_SET);
+        ThreadPool pool(3);
+        Channel<LineBatch> raw(pool, 1), kept(pool, 1, workers);
+        Channel<String> text(pool, 1, workers);
+        PipelineNumber number;
+        pool.spawn(ReadLines(in.fd, raw, 64));
+        for(size_t i = 0; i < workers; ++i) {
+            pool.spawn(FilterLines(raw, kept, "^ERROR"));
+            pool.spawn(TransformLines(kept, text, number));
+        }
+        pool.spawn(WriteLines(text, -1));
+        EXPECT_THROW(pool.wait(), std::system_error);
+    }
+}
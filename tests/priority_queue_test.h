@@ -0,0 +1,93 @@
+// priority queue test
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <exception>
+
+#include "../lib/CountingAllocator.h"
+#include "../lib/PriorityQueue.h"
+#include "../lib/String.h"
+
+
+// non trivial item, ordered by deadline
+struct Job {
+    int deadline;
+    String name;
+};
+inline bool operator<(const Job& a, const Job& b) { return a.deadline < b.deadline; }
+
+
+TEST(PriorityQueueTest, PushPop) {
+    PriorityQueue<int> q0;
+    EXPECT_THROW(q0.top(), std::out_of_range);
+    EXPECT_THROW(q0.pop(), std::underflow_error);
+    int arr[] = {5, 1, 9, 3, 7, 3, 0, 8, 2, 6, 4};
+    for(int i = 0; i < 11; ++i) q0.push(arr[i]);
+    int sorted[] = {0, 1, 2, 3, 3, 4, 5, 6, 7, 8, 9};
+    for(int i = 0; i < 11; ++i) {
+        EXPECT_EQ(q0.top(), sorted[i]);
+        q0.pop();
+    }
+    EXPECT_TRUE(q0.empty());
+
+    // max first, binary, non trivial items
+    PriorityQueue<Job, Greater, 2> q1;
+    q1.push(Job{2, "b"});
+    q1.push(Job{4, "d"});
+    q1.push(Job{1, "a"});
+    q1.push(Job{3, "c"});
+    EXPECT_EQ(q1.top().name, String("d"));
+    q1.pop();
+    EXPECT_EQ(q1.top().name, String("c"));
+    EXPECT_EQ(q1.size(), 3);
+}
+
+TEST(PriorityQueueTest, Heapify) {
+    AllocStats stats("heap");
+    AllocTag tag(stats);
+    Vector<int, _CountingAllocator<int>> v0;
+    v0.reserve(1000);
+    for(int i = 0; i < 1000; ++i) v0.push_back((i * 7919) % 1000);
+    // heapified in place, no allocation
+    PriorityQueue<int, Less, 8, _CountingAllocator<int>> q0(std::move(v0));
+    EXPECT_EQ(stats.allocations(), 1);
+    EXPECT_EQ(q0.size(), 1000);
+    for(int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(q0.top(), i);
+        q0.pop();
+    }
+    PriorityQueue<int, Greater, 3> q1({4, 8, 1, 8});
+    EXPECT_EQ(q1.top(), 8);
+    q1.pop();
+    EXPECT_EQ(q1.top(), 8);
+}
+
+TEST(PriorityQueueTest, Indexed) {
+    IndexedPriorityQueue<int> q0;
+    IndexedPriorityQueue<int>::Handle h[8];
+    int arr[] = {50, 10, 90, 30, 70, 20, 80, 60};
+    for(int i = 0; i < 8; ++i) h[i] = q0.push(arr[i]);
+    EXPECT_EQ(q0.top(), 10);
+    EXPECT_EQ(q0.top_handle(), h[1]);
+    // reprioritize
+    q0.decrease_key(h[6], 5);
+    EXPECT_EQ(q0.top(), 5);
+    EXPECT_EQ(q0.value(h[6]), 5);
+    EXPECT_THROW(q0.decrease_key(h[0], 55), std::invalid_argument);
+    // cancel
+    q0.erase(h[1]);
+    q0.erase(h[2]);
+    EXPECT_FALSE(q0.contains(h[1]));
+    EXPECT_THROW(q0.erase(h[1]), std::out_of_range);
+    EXPECT_EQ(q0.size(), 6);
+    int sorted[] = {5, 20, 30, 50, 60, 70};
+    for(int i = 0; i < 6; ++i) {
+        EXPECT_EQ(q0.top(), sorted[i]);
+        q0.pop();
+    }
+    // handles are reused
+    IndexedPriorityQueue<int>::Handle h1 = q0.push(1);
+    EXPECT_LT(h1, 8);
+    EXPECT_EQ(q0.value(h1), 1);
+}
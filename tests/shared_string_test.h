@@ -0,0 +1,80 @@
+// shared string test
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <exception>
+
+#include "../lib/CountingAllocator.h"
+#include "../lib/SharedString.h"
+
+
+typedef _SharedString<char, _CountingAllocator<char>> CSharedString;
+
+
+TEST(SharedStringTest, Constructors) {
+    SharedString s0;
+    EXPECT_STREQ(s0.c_str(), "");
+    EXPECT_EQ(s0.use_count(), 0);
+    SharedString s1("hello");
+    EXPECT_STREQ(s1.c_str(), "hello");
+    EXPECT_EQ(s1.length(), 5);
+    // copies share the buffer
+    SharedString s2(s1);
+    EXPECT_EQ(s1.c_str(), s2.c_str());
+    EXPECT_EQ(s1.use_count(), 2);
+    // move
+    SharedString s3(std::move(s2));
+    EXPECT_EQ(s2.use_count(), 0);
+    EXPECT_EQ(s3.use_count(), 2);
+    // conversions
+    String s4("world");
+    SharedString s5(s4);
+    EXPECT_TRUE(s5.to_string() == s4);
+    EXPECT_THROW(SharedString((const char*)NULL), std::invalid_argument);
+}
+
+TEST(SharedStringTest, FanOut) {
+    AllocStats stats("shared");
+    AllocTag tag(stats);
+    CSharedString s0("payload");
+    {
+        CSharedString subscribers[100];
+        for(int i = 0; i < 100; ++i) subscribers[i] = s0;
+        EXPECT_EQ(s0.use_count(), 101);
+        EXPECT_EQ(stats.allocations(), 1);
+    }
+    EXPECT_EQ(s0.use_count(), 1);
+    EXPECT_EQ(stats.deallocations(), 0);
+}
+
+TEST(SharedStringTest, CopyOnWrite) {
+    SharedString s0("abc");
+    SharedString s1 = s0;
+    // += detaches the writer only
+    s1 += 'd';
+    EXPECT_STREQ(s0.c_str(), "abc");
+    EXPECT_STREQ(s1.c_str(), "abcd");
+    EXPECT_EQ(s0.use_count(), 1);
+    EXPECT_EQ(s1.use_count(), 1);
+    s1 += s1;
+    EXPECT_STREQ(s1.c_str(), "abcdabcd");
+    // mutable [] detaches and stops sharing
+    SharedString s2 = s0;
+    char& c = s2[0];
+    c = 'x';
+    EXPECT_STREQ(s0.c_str(), "abc");
+    EXPECT_STREQ(s2.c_str(), "xbc");
+    SharedString s3 = s2;
+    EXPECT_NE(s3.c_str(), s2.c_str());
+    c = 'y';
+    EXPECT_STREQ(s3.c_str(), "xbc");
+    EXPECT_THROW(s2[3], std::out_of_range);
+    EXPECT_THROW(s2[-1], std::out_of_range);
+    // const access and search never detach
+    const SharedString s4 = s0;
+    EXPECT_EQ(s4[1], 'b');
+    EXPECT_EQ(*s4.find('c'), 'c');
+    EXPECT_TRUE(s4.match("^a.c$"));
+    EXPECT_EQ(s0.use_count(), 2);
+}
@@ -0,0 +1,107 @@
+// small vector test
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <exception>
+#include <iterator>
+#include <sstream>
+
+#include "../lib/CountingAllocator.h"
+#include "../lib/SmallVector.h"
+
+
+template <class T, size_t N> using CSmallVector = SmallVector<T, N, _CountingAllocator<T>>;
+
+
+TEST(SmallVectorTest, Inline) {
+    AllocStats stats("small");
+    AllocTag tag(stats);
+    CSmallVector<int, 4> v0;
+    for(int i = 0; i < 4; ++i) v0.push_back(i);
+    EXPECT_TRUE(v0.is_inline());
+    EXPECT_EQ(v0.capacity(), 4);
+    // copy and move of inline vectors never allocate
+    CSmallVector<int, 4> v1(v0);
+    CSmallVector<int, 4> v2(std::move(v1));
+    EXPECT_EQ(stats.allocations(), 0);
+    EXPECT_TRUE(v1.empty());
+    int arr[] = {0, 1, 2, 3};
+    for(int i = 0; i < 4; ++i) EXPECT_EQ(v2[i], arr[i]);
+    EXPECT_THROW(v2[4], std::out_of_range);
+    EXPECT_THROW(v2[-1], std::out_of_range);
+}
+
+TEST(SmallVectorTest, Spill) {
+    AllocStats stats("small");
+    AllocTag tag(stats);
+    CSmallVector<int, 2> v0({1, 2});
+    v0.push_back(3);
+    EXPECT_FALSE(v0.is_inline());
+    EXPECT_EQ(stats.allocations(), 1);
+    EXPECT_EQ(v0.capacity(), 6);
+    // heap buffers are stolen on move
+    CSmallVector<int, 2> v1(std::move(v0));
+    EXPECT_EQ(stats.allocations(), 1);
+    EXPECT_TRUE(v0.is_inline());
+    EXPECT_EQ(v1.back(), 3);
+    // back inline once it fits again
+    v1.pop_back();
+    v1.shrink();
+    EXPECT_TRUE(v1.is_inline());
+    EXPECT_EQ(v1.size(), 2);
+    EXPECT_EQ(v1.back(), 2);
+    EXPECT_EQ(stats.live_bytes(), 0);
+}
+
+TEST(SmallVectorTest, Iterator) {
+    SmallVector<int, 4> v0({1, 3, 5, 7});
+    EXPECT_EQ(*(v0.begin() + 2), 5);
+    EXPECT_EQ(*(v0.end() - 1), 7);
+    v0.insert(v0.begin() + 2, 3, 9);
+    int arr2[] = {1, 3, 9, 9, 9, 5, 7};
+    EXPECT_EQ(v0.size(), 7);
+    for(int i = 0; i < 7; ++i) EXPECT_EQ(v0[i], arr2[i]);
+    SmallVector<int, 4> v1(v0.rbegin(), v0.rend());
+    Reverse(v1.begin(), v1.end());
+    v0.insert(v0.begin() + 2, v1.begin(), v1.end());
+    int arr3[] = {1, 3, 1, 3, 9, 9, 9, 5, 7, 9, 9, 9, 5, 7};
+    EXPECT_EQ(v0.size(), 14);
+    for(int i = 0; i < 14; ++i) EXPECT_EQ(v0[i], arr3[i]);
+    // single pass input iterator, read only once
+    std::istringstream in("4 4 4");
+    v0.insert(v0.begin() + 1, std::istream_iterator<int>(in), std::istream_iterator<int>());
+    int arr4[] = {1, 4, 4, 4, 3, 1, 3, 9, 9, 9, 5, 7, 9, 9, 9, 5, 7};
+    EXPECT_EQ(v0.size(), 17);
+    for(int i = 0; i < 17; ++i) EXPECT_EQ(v0[i], arr4[i]);
+}
+
+TEST(SmallVectorTest, Template) {
+    // every constructed object is destroyed exactly once, inline or not
+    struct Counted {
+        int *cnt;
+        Counted(int* n): cnt{n} { ++*cnt; }
+        Counted(const Counted& c): cnt{c.cnt} { ++*cnt; }
+        Counted(Counted&& c): cnt{c.cnt} { ++*cnt; }
+        Counted& operator=(const Counted&) = delete;
+        ~Counted() { --*cnt; }
+    };
+    int cnt = 0;
+    {
+        SmallVector<Counted, 2> v0;
+        Counted c(&cnt);
+        for(int i = 0; i < 5; ++i) v0.push_back(c);
+        EXPECT_EQ(cnt, 6);
+        SmallVector<Counted, 2> v1;
+        v1 = std::move(v0);
+        EXPECT_EQ(cnt, 6);
+        v1.resize(1, c);
+        EXPECT_EQ(cnt, 2);
+        SmallVector<Counted, 2> v2(v1);
+        v0 = v2;
+        EXPECT_EQ(cnt, 4);
+        v1.clear();
+        EXPECT_EQ(cnt, 3);
+    }
+    EXPECT_EQ(cnt, 0);
+}
@@ -0,0 +1,186 @@
+// sort test
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "../lib/Algorithm.h"
+#include "../lib/CountingAllocator.h"
+#include "../lib/Sort.h"
+#include "../lib/String.h"
+#include "../lib/Vector.h"
+
+
+// inputs quicksorts are known to struggle with
+inline std::vector<std::vector<int>> SortPatterns(const size_t& n) {
+    std::mt19937 gen(3);
+    std::vector<std::vector<int>> ret(7, std::vector<int>(n));
+    for(size_t i = 0; i < n; ++i) {
+        ret[0][i] = (int)gen();                              // random
+        ret[1][i] = (int)i;                                  // sorted
+        ret[2][i] = (int)(n - i);                            // reversed
+        ret[3][i] = (int)(gen() % 4);                        // few distinct keys
+        ret[4][i] = (int)(i < n / 2 ? i : n - i);            // organ pipe
+        ret[5][i] = (int)(i % 2 ? i : n + i);                // interleaved
+        ret[6][i] = (int)(i == n - 1 ? 0 : i);               // sorted but the last
+    }
+    return ret;
+}
+
+TEST(SortTest, PatternDefeating) {
+    for(size_t n : {0, 1, 2, 23, 24, 100, 129, 5000}) {
+        for(std::vector<int>& v : SortPatterns(n)) {
+            std::vector<int> expected = v;
+            std::sort(expected.begin(), expected.end());
+            std::vector<int> a = v, b = v;
+            Sort(a.data(), a.data() + a.size());
+            EXPECT_EQ(a, expected);
+            HeapSort(b.data(), b.data() + b.size(), Less());
+            EXPECT_EQ(b, expected);
+        }
+    }
+    // through the library's iterators, with a comparator
+    Vector<int> v = {5, 1, 4, 1, 5, 9, 2, 6};
+    Sort(v.begin(), v.end(), Greater());
+    Vector<int> expected = {9, 6, 5, 5, 4, 2, 1, 1};
+    for(size_t i = 0; i < v.size(); ++i) EXPECT_EQ(v[i], expected[i]);
+
+    constexpr int first = [] {
+        int a[40] = {};
+        for(int i = 0; i < 40; ++i) a[i] = (i * 17) % 40;
+        Sort(a, a + 40);
+        return a[0] + a[39];
+    }();
+    EXPECT_EQ(first, 39);
+}
+
+TEST(SortTest, StableSort) {
+    struct Item {
+        int key;
+        int order;
+    };
+    std::mt19937 gen(4);
+    Vector<Item> items, scratch;
+    for(int i = 0; i < 3000; ++i) items.push_back(Item{(int)(gen() % 50), i});
+    auto by_key = [](const Item& a, const Item& b) { return a.key < b.key; };
+    std::vector<Item> expected(items.begin(), items.end());
+    std::stable_sort(expected.begin(), expected.end(), by_key);
+
+    StableSortVector(items, scratch, by_key);
+    ASSERT_EQ(scratch.size(), items.size());
+    for(size_t i = 0; i < items.size(); ++i) {
+        EXPECT_EQ(items[i].key, expected[i].key);
+        EXPECT_EQ(items[i].order, expected[i].order);
+    }
+}
+
+template <class T>
+void CheckRadixSort(const size_t& n) {
+    std::mt19937_64 gen(5);
+    Vector<T> v, scratch;
+    for(size_t i = 0; i < n; ++i) v.push_back((T)gen());
+    std::vector<T> expected(v.begin(), v.end());
+    std::sort(expected.begin(), expected.end());
+    SortVector(v, scratch);
+    EXPECT_EQ(std::vector<T>(v.begin(), v.end()), expected);
+}
+
+TEST(SortTest, Radix) {
+    CheckRadixSort<uint64_t>(10000);
+    CheckRadixSort<int64_t>(10000);
+    CheckRadixSort<int32_t>(10000);
+    CheckRadixSort<uint16_t>(10000);
+    CheckRadixSort<int8_t>(1000);
+    CheckRadixSort<int>(100);
+
+    // high bytes all zero: those passes are skipped, the result still lands in v
+    Vector<uint64_t> small;
+    for(uint64_t i = 0; i < 1000; ++i) small.push_back((i * 7919) % 1000);
+    SortVector(small);
+    for(size_t i = 0; i < small.size(); ++i) EXPECT_EQ(small[i], i);
+}
+
+TEST(SortTest, RadixScratchReused) {
+    AllocStats stats("sort");
+    AllocTag tag(stats);
+    typedef Vector<uint64_t, _CountingAllocator<uint64_t>> Keys;
+    Keys v, scratch;
+    v.reserve(5000);
+    for(uint64_t i = 0; i < 5000; ++i) v.push_back(i * 2654435761u);
+    SortVector(v, scratch);
+    size_t after_first = stats.allocations();
+    for(uint64_t i = 0; i < 5000; ++i) v[i] = i * 40503u;
+    SortVector(v, scratch);
+    EXPECT_EQ(stats.allocations(), after_first);
+    for(size_t i = 1; i < v.size(); ++i) EXPECT_LE(v[i - 1], v[i]);
+}
+
+TEST(SortTest, Strings) {
+    std::mt19937 gen(6);
+    Vector<String> v;
+    // shared prefixes, duplicates, empty strings and bytes above 127
+    const char* prefixes[] = {"", "a", "ab", "abc", "\xe9t\xe9", "zz"};
+    for(int i = 0; i < 5000; ++i) {
+        String s(prefixes[gen() % 6]);
+        for(size_t j = gen() % 4; j > 0; --j) s += (char)("abz\xe9"[gen() % 4]);
+        v.push_back(s);
+    }
+    std::vector<String> expected(v.begin(), v.end());
+    std::sort(expected.begin(), expected.end(), [](const String& a, const String& b) {
+        return strcmp(a.c_str(), b.c_str()) < 0;
+    });
+
+    // no allocation, strings are swapped in place
+    AllocStats stats("sort strings");
+    AllocTag tag(stats);
+    typedef _String<char, _CountingAllocator<char>> CountedString;
+    Vector<CountedString> cv;
+    for(size_t i = 0; i < v.size(); ++i) cv.push_back(CountedString(v[i].c_str()));
+    size_t before = stats.allocations();
+    SortVector(cv);
+    EXPECT_EQ(stats.allocations(), before);
+    // the swapped strings kept their allocators' block state: every growth is a reallocation
+    CountedString tail("xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx");
+    size_t allocated = stats.allocations(), reallocated = stats.reallocations();
+    for(size_t i = 0; i < cv.size(); ++i) cv[i] += tail;
+    EXPECT_EQ(stats.allocations() - allocated, cv.size());
+    EXPECT_EQ(stats.reallocations() - reallocated, cv.size());
+
+    SortVector(v);
+    for(size_t i = 0; i < v.size(); ++i) {
+        EXPECT_EQ(v[i], expected[i]);
+        EXPECT_EQ(cv[i].length(), expected[i].length() + tail.length());
+        EXPECT_EQ(strncmp(cv[i].c_str(), expected[i].c_str(), expected[i].length()), 0);
+    }
+}
+
+TEST(SortTest, StringsWithNul) {
+    // equal up to the NUL for strcmp, ordered by every char up to length() here
+    String a("a"), a0("a"), a0a("a"), a0b("a"), ab("ab");
+    a0 += '\0';
+    a0a += '\0';
+    a0a += 'a';
+    a0b += '\0';
+    a0b += 'b';
+    const String* keys[] = {&a, &a0, &a0a, &a0b, &ab};
+    // enough copies for the partitions to run, not only the insertion sort
+    std::mt19937 gen(7);
+    Vector<String> v;
+    for(int i = 0; i < 100; ++i) v.push_back(*keys[gen() % 5]);
+    std::vector<String> expected(v.begin(), v.end());
+    std::sort(expected.begin(), expected.end(), [&](const String& x, const String& y) {
+        size_t n = std::min(x.length(), y.length());
+        int c = memcmp(x.c_str(), y.c_str(), n);
+        return c < 0 || (c == 0 && x.length() < y.length());
+    });
+    SortVector(v);
+    for(size_t i = 0; i < v.size(); ++i) {
+        ASSERT_EQ(v[i].length(), expected[i].length());
+        EXPECT_EQ(memcmp(v[i].c_str(), expected[i].c_str(), v[i].length()), 0);
+    }
+}
@@ -0,0 +1,34 @@
+// static string test
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <exception>
+
+#include "../lib/StaticString.h"
+
+
+TEST(StaticStringTest, Constexpr) {
+    constexpr StaticString s0("select");
+    static_assert(s0.length() == 6 && s0.capacity() == 6, "deduced capacity");
+    static_assert(s0[2] == 'l', "access");
+    static_assert(s0 == "select", "equal");
+    static_assert(!(s0 == "selec"), "not equal");
+    constexpr auto s1 = s0 + StaticString(" *");
+    static_assert(s1.capacity() == 8 && s1 == "select *", "concat");
+    static_assert(*s1.find('*') == '*', "find");
+    EXPECT_STREQ(s1.c_str(), "select *");
+}
+
+TEST(StaticStringTest, Runtime) {
+    StaticString<4> s0("ab");
+    s0 += 'c';
+    s0 += StaticString("d");
+    EXPECT_STREQ(s0.c_str(), "abcd");
+    EXPECT_THROW(s0 += 'e', std::overflow_error);
+    EXPECT_THROW(StaticString<2>("abc"), std::overflow_error);
+    EXPECT_THROW(s0[4], std::out_of_range);
+    String s1 = s0.to_string();
+    EXPECT_TRUE(s1 == "abcd");
+    EXPECT_TRUE(s0.match("^ab.d$"));
+}
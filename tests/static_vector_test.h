@@ -0,0 +1,56 @@
+// static vector test
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <exception>
+
+#include "../lib/StaticVector.h"
+
+
+// built and sorted by the compiler
+constexpr StaticVector<int, 8> sorted_table() {
+    StaticVector<int, 8> v{5, 3, 7, 1};
+    v.push_back(4);
+    Sort(v.begin(), v.end());
+    return v;
+}
+
+constexpr StaticVector<int, 8> reversed_table() {
+    StaticVector<int, 8> v = sorted_table();
+    Reverse(v.begin(), v.end());
+    Swap(v[0], v[1]);
+    return v;
+}
+
+
+TEST(StaticVectorTest, Constexpr) {
+    constexpr StaticVector<int, 8> v0 = sorted_table();
+    static_assert(v0.size() == 5, "size");
+    static_assert(v0[0] == 1 && v0[4] == 7, "sorted");
+    static_assert(Min(v0[1], v0[2]) == 3, "min");
+    constexpr StaticVector<int, 8> v1 = reversed_table();
+    static_assert(v1[0] == 5 && v1[1] == 7 && v1[4] == 1, "reversed");
+    static_assert(v1 == StaticVector<int, 8>{5, 7, 4, 3, 1}, "equal");
+    int arr[] = {1, 3, 4, 5, 7};
+    int i = 0;
+    for(auto it = v0.begin(); it != v0.end(); ++it, ++i) EXPECT_EQ(*it, arr[i]);
+    EXPECT_EQ(i, 5);
+}
+
+TEST(StaticVectorTest, Runtime) {
+    StaticVector<int, 3> v0(2, 9);
+    v0.push_back(1);
+    EXPECT_THROW(v0.push_back(2), std::overflow_error);
+    EXPECT_THROW(v0[3], std::out_of_range);
+    v0.pop_back();
+    EXPECT_EQ(v0.back(), 9);
+    EXPECT_THROW((StaticVector<int, 1>{1, 2}), std::overflow_error);
+    // conversion to Vector
+    Vector<int> v1 = v0.to_vector();
+    EXPECT_EQ(v1.size(), 2);
+    EXPECT_EQ(v1.capacity(), 2);
+    EXPECT_EQ(v1[1], 9);
+    Vector<int> v2 = StaticVector<int, 4>{1, 2, 3}.to_vector();
+    EXPECT_EQ(v2.size(), 3);
+}
@@ -2,6 +2,8 @@
 
 #include <gtest/gtest.h>
 #include <exception>
+#include <iterator>
+#include <sstream>
 
 #include "../lib/Vector.h"
 
@@ -87,6 +89,11 @@ TEST(VectorTest, Iterator) {
     v0.insert(v0.begin() + 2, v1.begin(), v1.end());
     int arr3[] = {1, 3, 1, 3, 9, 9, 9, 5, 7, 9, 9, 9, 5 ,7};
     EXPECT_ARREQ(v0, arr3, 14);
+    // single pass input iterator, read only once
+    std::istringstream in("4 4 4");
+    v0.insert(v0.begin() + 1, std::istream_iterator<int>(in), std::istream_iterator<int>());
+    int arr4[] = {1, 4, 4, 4, 3, 1, 3, 9, 9, 9, 5, 7, 9, 9, 9, 5 ,7};
+    EXPECT_ARREQ(v0, arr4, 17);
 }
 
 TEST(VectorTest, Template) {